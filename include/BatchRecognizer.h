@@ -0,0 +1,39 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_BATCHRECOGNIZER_H
+#define MB_PROGRAMMEEROPDRACHTEN_BATCHRECOGNIZER_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "CompiledGrammar.h"
+
+using namespace std;
+
+// Bit-sliced CYK: 64 invoerstrings van dezelfde lengte delen één doorloop van de tabel.
+// Elke cel heeft per variabele een 64-bit masker, bit l staat voor invoer l van de groep, dus
+// A -> B C wordt cel[A] |= links[B] & rechts[C] voor alle 64 tegelijk.
+// Zelfde semantiek als CYKParser: enkel A -> a en A -> B C.
+class BatchRecognizer {
+public:
+    static constexpr size_t Lanes = 64;
+
+    explicit BatchRecognizer(const CompiledGrammar &grammar);
+
+    // resultaat[i] hoort bij inputs[i]; de invoer wordt zelf per lengte in groepen van 64 verdeeld
+    vector<bool> accepts(const vector<string> &inputs);
+
+    // hoogstens 64 invoerstrings die allemaal even lang zijn; bit l van het resultaat is group[l]
+    uint64_t acceptsGroup(span<const string_view> group);
+
+private:
+    const CompiledGrammar &grammar;
+    vector<size_t> rowStart;
+    vector<uint64_t> lanes;
+
+    uint64_t *cell(size_t length, size_t start) {
+        return lanes.data() + (rowStart[length] + start) * grammar.variableCount();
+    }
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_BATCHRECOGNIZER_H
@@ -0,0 +1,35 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_BITS_H
+#define MB_PROGRAMMEEROPDRACHTEN_BITS_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Verzamelingen van variabelen als rijen van 64-bit woorden, bit A staat voor variabele A.
+
+inline bool testBit(const uint64_t *set, uint32_t i) {
+    return (set[i >> 6] >> (i & 63)) & 1;
+}
+
+inline void setBit(uint64_t *set, uint32_t i) {
+    set[i >> 6] |= uint64_t(1) << (i & 63);
+}
+
+inline bool anyBit(const uint64_t *set, size_t words) {
+    for (size_t w = 0; w < words; ++w) {
+        if (set[w]) return true;
+    }
+    return false;
+}
+
+// visit(i) voor elke gezette bit, oplopend
+template<typename F>
+inline void forEachBit(const uint64_t *set, size_t words, F visit) {
+    for (size_t w = 0; w < words; ++w) {
+        for (uint64_t bits = set[w]; bits; bits &= bits - 1) {
+            visit(static_cast<uint32_t>(w * 64 + std::countr_zero(bits)));
+        }
+    }
+}
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_BITS_H
@@ -5,22 +5,72 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <ostream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include "ProductionTable.h"
 
 using namespace std;
 
+class ParseResult;
+class CompiledGrammar;
+
+// naam van een variabele zoals CFG::print ze toont: X of [p,X,q]
+string symbolName(const vector<string> &symbol);
+
 class CFG {
 public:
     vector<vector<string>> V;
     vector<string> T;
-    map<vector<string>, vector<vector<vector<string>>>> P;
+    // producties in CSR-vorm; P[head].push_back(body) en een for-lus over P werken nog zoals bij de oude map
+    ProductionTable P;
     string S;
 
     explicit CFG(const string &filename);
     CFG () = default;
 
     void print() const;
+    // zelfde uitvoer als print, naar een willekeurige stream
+    void print(ostream &out) const;
+
+    // alle producties als (head, body) met symboolnamen zoals print ze toont, epsilon weggelaten
+    void forEachProduction(const function<void(const string &, const vector<string> &)> &visit) const;
+
+    // als JSON in het formaat van de constructor, zodat een resultaat van toCFG bewaard kan worden
+    void write(ostream &out) const;
+    void save(const string &filename) const;
+
+    // CYK op input zonder iets te printen; met keepTable zit de volledige tabel in het resultaat,
+    // om ze bijvoorbeeld met een TableRenderer te tonen
+    ParseResult accepts(const string &input, bool keepTable = false) const;
+
+    // De gecompileerde vorm die accepts gebruikt. Wordt één keer gemaakt en opnieuw zodra P (revision of
+    // aantal regels) verandert of de inhoud van V, T of S anders is dan bij het compileren; thread-safe.
+    // V en T vergelijken kost O(|V| + |T|) per oproep, nog altijd veel minder dan compileren.
+    shared_ptr<const CompiledGrammar> compiled() const;
+
+private:
+    // een kopie van de CFG begint met een lege cache
+    struct CompiledCache {
+        mutex lock;
+        shared_ptr<const CompiledGrammar> grammar;
+        uint64_t revision = 0;
+        size_t rules = 0;
+        // kopieën van V, T en S bij het compileren, zodat elke wijziging (ook een hernoemde terminal) opvalt
+        vector<vector<string>> variables;
+        vector<string> terminals;
+        string start;
 
-    void accepts(string input);
+        CompiledCache() = default;
+        CompiledCache(const CompiledCache &) {}
+        CompiledCache &operator=(const CompiledCache &) {
+            lock_guard<mutex> guard(lock);
+            grammar.reset();
+            return *this;
+        }
+    };
+    mutable CompiledCache cache;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_CFGWRITER_H
+#define MB_PROGRAMMEEROPDRACHTEN_CFGWRITER_H
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// text als JSON-string (met aanhalingstekens) achteraan into; de enige JSON-escape in het project
+void appendJSONString(string &into, string_view text);
+
+// Schrijft een grammatica als JSON in hetzelfde formaat dat CFG::CFG inleest, stuk per stuk:
+// eerst alle variabelen, dan de terminals, dan de producties en tot slot het startsymbool.
+// Er wordt niets bijgehouden, dus ook enorme grammatica's gaan in constant geheugen naar de stream.
+class CFGWriter {
+public:
+    explicit CFGWriter(ostream &out);
+
+    void variable(const string &name);
+    void terminal(const string &name);
+    void production(const string &head, const vector<string> &body);
+    void start(const string &name);
+
+private:
+    enum Section { None, Variables, Terminals, Productions, Done };
+
+    ostream &out;
+    Section section = None;
+    bool first = true;
+    string scratch;
+
+    void enter(Section next);
+    void write(const string &text);
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_CFGWRITER_H
@@ -0,0 +1,47 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_CYKPARSER_H
+#define MB_PROGRAMMEEROPDRACHTEN_CYKPARSER_H
+
+#include <string_view>
+#include "CompiledGrammar.h"
+#include "CYKTable.h"
+#include "ParseResult.h"
+
+using namespace std;
+
+// CYK over een gedeelde CompiledGrammar. De parser zelf heeft enkel werkgeheugen (de tabel),
+// dus per thread één parser en dezelfde grammatica voor allemaal.
+// Zoals CFG::accepts altijd deed worden enkel A -> a en A -> B C gebruikt.
+class CYKParser {
+public:
+    // eerst CompiledGrammar::mayAccept proberen; bij een vroege afwijzing blijft de tabel leeg
+    bool Prefilter = true;
+
+    explicit CYKParser(const CompiledGrammar &grammar);
+
+    bool accepts(string_view input);
+
+    // accepts, maar de tabel gaat mee in het resultaat (de parser begint daarna met een lege tabel)
+    ParseResult parse(string_view input);
+
+    // de tabel van de laatste oproep van accepts
+    const CYKTable &table() const { return cells; }
+
+    // Tweede pas van boven naar onder: markeer enkel de (variabele, span) die in een afleiding van S
+    // over de hele invoer voorkomen. Geeft het aantal bruikbare entries terug (0 als niet aanvaard).
+    size_t pruneToRoot();
+    // resultaat van pruneToRoot, zelfde vorm als table()
+    const CYKTable &usable() const { return useful; }
+
+    // aantal parse trees van de laatste invoer (als double, het groeit exponentieel);
+    // telt enkel over de bruikbare entries, dus doet zelf pruneToRoot als dat nog niet gebeurd is
+    double derivations();
+
+private:
+    const CompiledGrammar &grammar;
+    CYKTable cells;
+    CYKTable useful;
+    bool accepted = false;
+    bool pruned = false;
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_CYKPARSER_H
@@ -0,0 +1,38 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_CYKTABLE_H
+#define MB_PROGRAMMEEROPDRACHTEN_CYKTABLE_H
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// CYK-tabel met per cel een bitset over de variabelen.
+// cell(length, start) hoort bij input[start .. start+length-1]; de cellen van één lengte staan na elkaar.
+class CYKTable {
+public:
+    size_t n = 0;
+    size_t words = 0;
+
+    void reset(size_t length, size_t wordsPerCell) {
+        n = length;
+        words = wordsPerCell;
+        rowStart.resize(n + 2);
+        rowStart[1] = 0;
+        for (size_t len = 1; len <= n; ++len) rowStart[len + 1] = rowStart[len] + (n - len + 1);
+        data.assign(rowStart[n + 1] * words, 0);
+    }
+
+    uint64_t *cell(size_t length, size_t start) {
+        return data.data() + (rowStart[length] + start) * words;
+    }
+
+    const uint64_t *cell(size_t length, size_t start) const {
+        return data.data() + (rowStart[length] + start) * words;
+    }
+
+private:
+    vector<size_t> rowStart;
+    vector<uint64_t> data;
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_CYKTABLE_H
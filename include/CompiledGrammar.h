@@ -0,0 +1,113 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_COMPILEDGRAMMAR_H
+#define MB_PROGRAMMEEROPDRACHTEN_COMPILEDGRAMMAR_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <string_view>
+#include "CFG.h"
+#include "GrammarImage.h"
+#include "LengthSet.h"
+
+using namespace std;
+
+// Onveranderlijke vorm van een CFG voor het herkennen van strings. Na de constructor verandert er
+// niets meer, dus één CompiledGrammar kan via een const-referentie door zoveel threads tegelijk
+// gebruikt worden als nodig; elke parser (CYKParser) heeft zijn eigen werkgeheugen.
+//
+// Variabelen en terminals hebben de nummers uit de GrammarImage: variabelen 0..V-1 alfabetisch,
+// dus een bitset over variabelen overlopen geeft ze meteen in gesorteerde volgorde.
+class CompiledGrammar {
+public:
+    explicit CompiledGrammar(const CFG &cfg);
+    explicit CompiledGrammar(GrammarImage image);
+
+    CompiledGrammar(const CompiledGrammar &) = delete;
+    CompiledGrammar &operator=(const CompiledGrammar &) = delete;
+
+    size_t variableCount() const { return image.variableCount(); }
+    size_t terminalCount() const { return image.terminalCount(); }
+    // aantal 64-bit woorden in een bitset over de variabelen
+    size_t words() const { return (image.variableCount() + 63) / 64; }
+
+    // uniek per CompiledGrammar in dit proces (ook als een oude op hetzelfde adres vrijgegeven is),
+    // bijvoorbeeld als sleutel in een ResultCache
+    uint64_t serial() const { return id; }
+
+    // -1 als de grammatica geen (geldig) startsymbool heeft
+    int start() const { return startId; }
+
+    string_view name(uint32_t symbol) const { return image.name(symbol); }
+    int variableId(string_view name) const;
+    int terminalId(string_view name) const;
+
+    // terminal voor een byte uit de invoer, -1 als er geen terminal van één teken is
+    int terminalOf(unsigned char c) const { return byteTerminal[c]; }
+
+    // bitset van alle A met A -> c, voor de eerste rij van CYK (words() woorden)
+    const uint64_t *byteVariables(unsigned char c) const { return byteSets.data() + c * words(); }
+
+    // enkel A -> B C, A -> a en eventueel S -> ε met S nergens rechts
+    bool isCNF() const { return cnf; }
+    // heeft het startsymbool een lege productie (voor de lege invoer)
+    bool derivesEmpty() const { return startEmpty; }
+
+    // Goedkope voorfilter in O(n): false als de invoer zeker niet afleidbaar is uit het startsymbool
+    // (een byte waar geen enkele variabele naar gaat, een eerste of laatste byte waarmee geen afleiding
+    // van S kan beginnen of eindigen, of een lengte buiten [minLength, maxLength] of buiten lengths(S)).
+    bool mayAccept(string_view input) const;
+
+    // enkel het lengtedeel van mayAccept
+    bool mayHaveLength(size_t n) const;
+    // de byteverzamelingen van mayAccept (bit c van woord c / 64): bytes die in een aanvaarde invoer kunnen
+    // voorkomen, en waarmee die kan beginnen of eindigen
+    const array<uint64_t, 4> &alphabetBytes() const { return alphabet; }
+    const array<uint64_t, 4> &firstByteSet() const { return firstBytes; }
+    const array<uint64_t, 4> &lastByteSet() const { return lastBytes; }
+
+    size_t minLength() const { return shortest; }
+    // SIZE_MAX als S willekeurig lange strings afleidt
+    size_t maxLength() const { return longest; }
+
+    // Lengtes die variabele A kan afleiden (met A -> c en A -> B C), als uiteindelijk periodieke verzameling.
+    // Altijd een superset van de echte lengtes; exact als de analyse een vast punt vond.
+    const LengthSet &lengths(uint32_t A) const { return lengthSets[A]; }
+
+    span<const uint32_t> unitHeads(uint32_t terminal) const { return image.unitHeads(terminal); }
+    span<const uint32_t> binaryRules(uint32_t left) const { return image.binaryRules(left); }
+    // enkel de paren (C, A) waarvan A een string van deze lengte kan afleiden
+    span<const uint32_t> binaryRules(uint32_t left, size_t length) const;
+    // false als geen enkele A -> B C een cel van deze lengte kan vullen
+    bool lengthPossible(size_t length) const;
+
+    const GrammarImage &rules() const { return image; }
+
+private:
+    uint64_t id = nextSerial();
+    GrammarImage image;
+    int startId = -1;
+    bool cnf = true;
+    bool startEmpty = false;
+    array<int, 256> byteTerminal{};
+    vector<uint64_t> byteSets;
+    array<uint64_t, 4> alphabet{};
+    array<uint64_t, 4> firstBytes{};
+    array<uint64_t, 4> lastBytes{};
+    size_t shortest = 0;
+    size_t longest = 0;
+    vector<LengthSet> lengthSets;
+    // per lengteklasse (lengte < lengthThreshold, daarna modulo lengthPeriod) de gefilterde binaryRules
+    size_t lengthThreshold = 0;
+    size_t lengthPeriod = 1;
+    vector<uint32_t> lengthRuleStart;
+    vector<uint32_t> lengthRules;
+
+    void analyse();
+    void analyseStart();
+    void analyseLengths();
+    size_t lengthClass(size_t length) const;
+    static uint64_t nextSerial();
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_COMPILEDGRAMMAR_H
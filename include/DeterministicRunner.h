@@ -0,0 +1,37 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_DETERMINISTICRUNNER_H
+#define MB_PROGRAMMEEROPDRACHTEN_DETERMINISTICRUNNER_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "TransitionIndex.h"
+
+using namespace std;
+
+// Voert een deterministische PDA rechtstreeks uit in één pass over de invoer (aanvaarden met lege stapel).
+// De stapel is een vector van stapelsymbool-nummers die tussen oproepen hergebruikt wordt,
+// dus na de eerste invoer wordt er per stap niets meer gealloceerd.
+// De index moet deterministisch zijn (TransitionIndex::isDeterministic) en blijft van de PDA.
+class DeterministicRunner {
+public:
+    explicit DeterministicRunner(const TransitionIndex &index);
+
+    bool accepts(string_view input);
+
+private:
+    const TransitionIndex &index;
+    vector<int> stack;
+
+    // lusdetectie voor reeksen epsilon-stappen, zie accepts
+    vector<unsigned> generation;
+    // run telt elke stap van elke oproep en loopt in 64 bits nooit over, ook niet voor een runner die zo
+    // lang leeft als zijn thread
+    vector<uint64_t> seenRun;
+    vector<size_t> seenLevel;
+    vector<unsigned> seenGeneration;
+    uint64_t run = 0;
+
+    bool epsilonStep(int &state);
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_DETERMINISTICRUNNER_H
@@ -0,0 +1,60 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_EPSILONCLOSURE_H
+#define MB_PROGRAMMEEROPDRACHTEN_EPSILONCLOSURE_H
+
+#include <span>
+#include <vector>
+#include "TransitionIndex.h"
+
+using namespace std;
+
+// Wat een PDA vanuit (state, stacktop) met enkel epsilon-transities kan bereiken, per paar één keer
+// berekend bij het inlezen:
+//  - pops: states waarin het stapelsymbool volledig weggewerkt is (de stapel eronder is nooit aangeraakt)
+//  - reach: configuraties (p, γ) met 1 <= |γ| <= Bound die bereikbaar zijn zonder onder X te komen
+//  - frontier: configuraties die in één stap boven Bound uitkomen; die moet de simulator zelf verder volgen
+// γ staat met de top vooraan.
+class EpsilonClosure {
+public:
+    struct Entry {
+        int state;
+        int wordStart;
+        int wordLength;
+    };
+
+    size_t Bound = 2;
+
+    EpsilonClosure() = default;
+    EpsilonClosure(const TransitionIndex &index, size_t bound = 2);
+
+    span<const int> pops(int state, int stacktop) const {
+        size_t key = static_cast<size_t>(state) * nStack + stacktop;
+        return {popStates.data() + popStart[key], popStates.data() + popStart[key + 1]};
+    }
+
+    span<const Entry> reach(int state, int stacktop) const {
+        size_t key = static_cast<size_t>(state) * nStack + stacktop;
+        return {reachEntries.data() + reachStart[key], reachEntries.data() + reachStart[key + 1]};
+    }
+
+    span<const Entry> frontier(int state, int stacktop) const {
+        size_t key = static_cast<size_t>(state) * nStack + stacktop;
+        return {frontierEntries.data() + frontierStart[key], frontierEntries.data() + frontierStart[key + 1]};
+    }
+
+    // kan X in minstens één state met enkel epsilon-stappen verdwijnen?
+    bool erasable(int stacktop) const { return erasableSymbols[stacktop]; }
+
+    span<const int> word(const Entry &entry) const {
+        return {words.data() + entry.wordStart, static_cast<size_t>(entry.wordLength)};
+    }
+
+private:
+    size_t nStack = 0;
+    vector<int> popStart, popStates;
+    vector<int> reachStart, frontierStart;
+    vector<Entry> reachEntries, frontierEntries;
+    vector<int> words;
+    vector<char> erasableSymbols;
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_EPSILONCLOSURE_H
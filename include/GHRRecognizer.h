@@ -0,0 +1,43 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_GHRRECOGNIZER_H
+#define MB_PROGRAMMEEROPDRACHTEN_GHRRECOGNIZER_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "CompiledGrammar.h"
+
+using namespace std;
+
+// Herkenner in de stijl van Graham-Harrison-Ruzzo: in plaats van een bitset over variabelen per cel
+// heeft elke (variabele A, beginpositie i) een bitvector over eindposities j, met bit j gezet als
+// A =>* input[i .. j-1]. De beginposities gaan van rechts naar links; voor een vaste i worden de
+// eindes k oplopend overlopen, en elke A -> B C met B over [i, k) wordt één OR over woorden:
+//     ends[A][i] |= ends[C][k]
+// Goed voor grammatica's met weinig variabelen en lange invoer (zoals input-cyk1.json), het geheugen
+// is |V| · n · n / 64 woorden. Zelfde semantiek als CYKParser: enkel A -> a en A -> B C.
+class GHRRecognizer {
+public:
+    // eerst CompiledGrammar::mayAccept proberen
+    bool Prefilter = true;
+
+    explicit GHRRecognizer(const CompiledGrammar &grammar);
+
+    bool accepts(string_view input);
+
+    // bitvector over eindposities 0..n voor A vanaf start, na de laatste oproep van accepts
+    const uint64_t *ends(uint32_t A, size_t start) const {
+        return bits.data() + (start * grammar.variableCount() + A) * words;
+    }
+    size_t wordsPerVector() const { return words; }
+
+private:
+    const CompiledGrammar &grammar;
+    size_t words = 0;
+    vector<uint64_t> bits;
+
+    uint64_t *ends(uint32_t A, size_t start) {
+        return bits.data() + (start * grammar.variableCount() + A) * words;
+    }
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_GHRRECOGNIZER_H
@@ -0,0 +1,90 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_GRAMMARIMAGE_H
+#define MB_PROGRAMMEEROPDRACHTEN_GRAMMARIMAGE_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "CFG.h"
+
+using namespace std;
+
+// Gecompileerde grammatica als één blok uint32_t's, dat zo naar een bestand geschreven kan worden
+// en bij het laden read-only gemapt wordt: niets te parsen en niets te kopiëren.
+//
+// Symbolen: variabelen 0..V-1 en daarna terminals V..V+T-1, elk deel alfabetisch op naam.
+// Producties staan gegroepeerd per head (CSR): de regels van A zijn headStart[A]..headStart[A+1]-1,
+// de body van regel r is body[bodyStart[r]..bodyStart[r+1]-1].
+// Daarnaast twee indexen voor CYK: per terminal a de heads van A -> a, en per variabele B
+// de paren (C, A) van A -> B C.
+class GrammarImage {
+public:
+    static constexpr uint32_t Magic = 0x474B5943; // "CYKG"
+    static constexpr uint32_t Version = 1;
+    static constexpr uint32_t None = 0xFFFFFFFF;
+
+    GrammarImage() = default;
+    GrammarImage(GrammarImage &&other) noexcept;
+    GrammarImage &operator=(GrammarImage &&other) noexcept;
+    GrammarImage(const GrammarImage &) = delete;
+    GrammarImage &operator=(const GrammarImage &) = delete;
+    ~GrammarImage();
+
+    static GrammarImage fromCFG(const CFG &cfg);
+    // geeft een lege image (valid() == false) als het bestand niet te openen of geen grammatica is
+    static GrammarImage load(const string &filename);
+    void save(const string &filename) const;
+
+    bool valid() const { return words != nullptr; }
+
+    uint32_t variableCount() const { return words[2]; }
+    uint32_t terminalCount() const { return words[3]; }
+    uint32_t symbolCount() const { return words[2] + words[3]; }
+    uint32_t start() const { return words[4]; }
+    uint32_t ruleCount() const { return words[5]; }
+
+    string_view name(uint32_t symbol) const {
+        return {names + nameStart[symbol], nameStart[symbol + 1] - nameStart[symbol]};
+    }
+
+    uint32_t head(uint32_t rule) const { return ruleHead[rule]; }
+    uint32_t firstRule(uint32_t head) const { return headStart[head]; }
+    uint32_t endRule(uint32_t head) const { return headStart[head + 1]; }
+
+    span<const uint32_t> body(uint32_t rule) const {
+        return {bodies + bodyStart[rule], bodies + bodyStart[rule + 1]};
+    }
+
+    span<const uint32_t> unitHeads(uint32_t terminal) const {
+        uint32_t t = terminal - variableCount();
+        return {unitHead + unitStart[t], unitHead + unitStart[t + 1]};
+    }
+
+    // afwisselend C en A voor alle A -> B C
+    span<const uint32_t> binaryRules(uint32_t left) const {
+        return {binaryPairs + 2 * binaryStart[left], binaryPairs + 2 * binaryStart[left + 1]};
+    }
+
+private:
+    vector<uint32_t> owned;
+    void *mapping = nullptr;
+    size_t mappingSize = 0;
+
+    const uint32_t *words = nullptr;
+    const uint32_t *nameStart = nullptr;
+    const uint32_t *ruleHead = nullptr;
+    const uint32_t *headStart = nullptr;
+    const uint32_t *bodyStart = nullptr;
+    const uint32_t *bodies = nullptr;
+    const uint32_t *unitStart = nullptr;
+    const uint32_t *unitHead = nullptr;
+    const uint32_t *binaryStart = nullptr;
+    const uint32_t *binaryPairs = nullptr;
+    const char *names = nullptr;
+
+    bool attach(const uint32_t *data, size_t count);
+    void release();
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_GRAMMARIMAGE_H
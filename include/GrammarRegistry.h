@@ -0,0 +1,69 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_GRAMMARREGISTRY_H
+#define MB_PROGRAMMEEROPDRACHTEN_GRAMMARREGISTRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CompiledGrammar.h"
+
+using namespace std;
+
+// Houdt de huidige versie van een grammatica bij terwijl er geparset wordt (RCU-stijl).
+// Een lezer neemt met current() een snapshot en houdt die vast tot zijn parse klaar is;
+// een nieuwe versie wordt volledig ingelezen en gecompileerd voor ze met één atomische store
+// gepubliceerd wordt. De gepubliceerde pointer is een gewone atomische pointer (atomic<shared_ptr> neemt
+// in libstdc++ een interne lock), beschermd met twee epoch-tellers: een lezer meldt zich enkel aan
+// voor het kopiëren van de shared_ptr en wacht nooit, een schrijver wacht tot de lezers van de vorige
+// epoch weg zijn voor hij de oude houder vrijgeeft. Een oude versie verdwijnt vanzelf zodra de laatste
+// snapshot ervan losgelaten wordt.
+class GrammarRegistry {
+public:
+    struct Version {
+        uint64_t number;
+        string source;
+        CompiledGrammar grammar;
+
+        Version(uint64_t number, string source, const CFG &cfg)
+            : number(number), source(std::move(source)), grammar(cfg) {}
+    };
+    using Snapshot = shared_ptr<const Version>;
+
+    GrammarRegistry() = default;
+    ~GrammarRegistry();
+
+    GrammarRegistry(const GrammarRegistry &) = delete;
+    GrammarRegistry &operator=(const GrammarRegistry &) = delete;
+
+    // nullptr zolang er nog niets gepubliceerd is
+    Snapshot current() const;
+
+    // inlezen via CFG::CFG en compileren op de huidige thread; false als het bestand geen producties gaf
+    bool reloadNow(const string &filename);
+    // hetzelfde op een achtergrondthread
+    void reload(const string &filename);
+    // wachten tot alle achtergrondreloads klaar zijn
+    void wait();
+
+private:
+    atomic<const Snapshot *> published{nullptr};
+    atomic<uint64_t> epoch{0};
+    // lezers die nu de shared_ptr kopiëren, per pariteit van de epoch waarin ze binnenkwamen
+    mutable atomic<uint64_t> readers[2]{};
+    atomic<uint64_t> versions{0};
+    mutex publishing;
+    mutex workersLock;
+    // achtergrondreloads; wie klaar is wordt bij de volgende reload() opgeruimd
+    struct Worker {
+        thread worker;
+        shared_ptr<atomic<bool>> done;
+    };
+    vector<Worker> workers;
+
+    void publish(Snapshot next);
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_GRAMMARREGISTRY_H
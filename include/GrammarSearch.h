@@ -0,0 +1,50 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_GRAMMARSEARCH_H
+#define MB_PROGRAMMEEROPDRACHTEN_GRAMMARSEARCH_H
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <string_view>
+#include <vector>
+#include "CompiledGrammar.h"
+
+using namespace std;
+
+// Zoekt in een lange tekst alle stukken [start, end) die afleidbaar zijn uit S (of een gekozen variabele),
+// met hoogstens limit tekens. CYK per eindpositie: de kolom van een eindpositie bevat de cellen voor
+// alle lengtes tot limit, en enkel de laatste limit kolommen worden in een ringbuffer bijgehouden.
+// Kost O(n · k²) in de tekstlengte n voor k = limit, en de tekst zelf hoeft nooit in het geheugen.
+class GrammarSearch {
+public:
+    using Match = function<void(size_t start, size_t end)>;
+
+    // target -1 = het startsymbool; een nummer dat geen variabele is wordt gemeld en vindt niets
+    GrammarSearch(const CompiledGrammar &grammar, size_t limit, int target = -1);
+
+    // verder lezen waar de vorige oproep stopte; match wordt opgeroepen per gevonden stuk,
+    // oplopend op end en voor dezelfde end van kort naar lang
+    void feed(string_view text, const Match &match);
+    // de hele stream in blokken doorlopen
+    void search(istream &in, const Match &match);
+
+    // opnieuw beginnen op positie 0
+    void reset();
+    // aantal tekens dat al gelezen is
+    size_t position() const { return consumed; }
+
+private:
+    const CompiledGrammar &grammar;
+    size_t maxSpan;
+    int target;
+    size_t consumed = 0;
+    // maxSpan kolommen van elk maxSpan cellen; kolom (end % maxSpan), cel lengte-1
+    vector<uint64_t> ring;
+
+    uint64_t *cell(size_t end, size_t length) {
+        return ring.data() + ((end % maxSpan) * maxSpan + (length - 1)) * grammar.words();
+    }
+
+    void step(unsigned char c, const Match &match);
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_GRAMMARSEARCH_H
@@ -0,0 +1,71 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_JSONSAX_H
+#define MB_PROGRAMMEEROPDRACHTEN_JSONSAX_H
+
+#include <string>
+#include "../json.hpp"
+
+using namespace std;
+
+// Basis voor de SAX-inlezers van CFG en PDA: het JSON-bestand wordt token per token verwerkt
+// in plaats van eerst volledig als json-boom in het geheugen te komen.
+// Houdt de nesting bij (het object rond alles is diepte 1) en de laatste sleutel per niveau;
+// getallen, booleans en null worden genegeerd.
+class JSONSax : public nlohmann::json_sax<nlohmann::json> {
+public:
+    std::string error;
+
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+    bool number_integer(number_integer_t) override { return true; }
+    bool number_unsigned(number_unsigned_t) override { return true; }
+    bool number_float(number_float_t, const string_t &) override { return true; }
+
+    bool string(string_t &val) override {
+        value(val);
+        return true;
+    }
+
+    bool key(string_t &val) override {
+        if (depth == 1) section = val;
+        else field = val;
+        return true;
+    }
+
+    bool start_object(size_t) override {
+        ++depth;
+        opened();
+        return true;
+    }
+
+    bool end_object() override {
+        closed();
+        --depth;
+        return true;
+    }
+
+    bool start_array(size_t) override {
+        ++depth;
+        return true;
+    }
+
+    bool end_array() override {
+        --depth;
+        return true;
+    }
+
+    bool parse_error(size_t, const std::string &, const nlohmann::detail::exception &ex) override {
+        error = ex.what();
+        return false;
+    }
+
+protected:
+    int depth = 0;
+    std::string section;    // sleutel in het buitenste object
+    std::string field;      // sleutel in een object in een lijst
+
+    virtual void value(std::string &val) = 0;
+    virtual void opened() {}
+    virtual void closed() {}
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_JSONSAX_H
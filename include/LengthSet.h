@@ -0,0 +1,22 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_LENGTHSET_H
+#define MB_PROGRAMMEEROPDRACHTEN_LENGTHSET_H
+
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// Uiteindelijk periodieke verzameling lengtes: exact tot Threshold, daarna herhaalt het
+// patroon van bits[Threshold .. Threshold+Period-1] zich voor altijd.
+struct LengthSet {
+    size_t Threshold = 0;
+    size_t Period = 1;
+    vector<char> bits = vector<char>(1, 0);
+
+    bool contains(size_t n) const {
+        if (n < bits.size()) return bits[n];
+        return bits[Threshold + (n - Threshold) % Period];
+    }
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_LENGTHSET_H
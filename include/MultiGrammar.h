@@ -0,0 +1,46 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_MULTIGRAMMAR_H
+#define MB_PROGRAMMEEROPDRACHTEN_MULTIGRAMMAR_H
+
+#include <string_view>
+#include <vector>
+#include "CompiledGrammar.h"
+#include "CYKParser.h"
+
+using namespace std;
+
+// Eén invoer tegen veel grammatica's tegelijk. De variabelen van alle grammatica's komen samen in één
+// CompiledGrammar (elke variabele krijgt het nummer van zijn grammatica als voorvoegsel, dus de ruimtes
+// overlappen niet), met per grammatica een eigen startsymbool. Eén CYK-doorloop vult de tabel voor
+// allemaal; de kost groeit met de totale grootte van de grammatica's, niet met hun aantal.
+// De voorfilters van alle grammatica's zijn samengevoegd tot per byte een bitset van grammatica's die die
+// byte (ergens, vooraan of achteraan) toelaten; één AND over de verschillende bytes van de invoer geeft de
+// kandidaten, zonder per grammatica over de invoer te lopen.
+// Zoals CYKParser heeft een MultiGrammar werkgeheugen, dus per thread één.
+class MultiGrammar {
+public:
+    // de grammatica's moeten blijven bestaan zolang de MultiGrammar gebruikt wordt
+    explicit MultiGrammar(const vector<const CompiledGrammar *> &grammars);
+
+    size_t grammarCount() const { return sources.size(); }
+
+    // de indices (in de volgorde van de constructor) van de grammatica's die input aanvaarden
+    vector<size_t> accepts(string_view input);
+
+    const CompiledGrammar &merged() const { return combined; }
+
+private:
+    vector<const CompiledGrammar *> sources;
+    CompiledGrammar combined;
+    // startsymbool van elke grammatica in combined, -1 als ze er geen heeft
+    vector<int> starts;
+    CYKParser parser;
+    // bitsets over de grammatica's van grammarWords woorden: per byte (256 stuks) en de grammatica's met een start
+    size_t grammarWords = 0;
+    vector<uint64_t> byteMask, firstMask, lastMask;
+    vector<uint64_t> withStart;
+    vector<uint64_t> candidates;
+
+    void buildPrefilter();
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_MULTIGRAMMAR_H
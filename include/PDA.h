@@ -1,11 +1,15 @@
 #ifndef MB_PROGRAMMEEROPDRACHTEN_PDA_H
 #define MB_PROGRAMMEEROPDRACHTEN_PDA_H
 
+#include <cstdint>
+#include <span>
 #include <utility>
 #include <vector>
 #include <map>
 #include <string>
 #include "CFG.h"
+#include "EpsilonClosure.h"
+#include "TransitionIndex.h"
 
 using namespace std;
 
@@ -17,6 +21,15 @@ struct Transition {
     vector<string> replacement;
 };
 
+// Productie van toCFG in getallen: een variabele [p,X,q] is (p·|Γ| + X)·|Q| + q met de nummers uit Index,
+// input een nummer uit Index.Inputs (-1 voor epsilon) en length het aantal variabelen in body.
+struct Production {
+    uint32_t head;
+    int input;
+    uint32_t body[2];
+    uint32_t length;
+};
+
 class PDA {
 public:
     vector<std::string> States;
@@ -26,9 +39,35 @@ public:
     string StartState;
     string StartStack;
 
+    // opgebouwd bij het inlezen, opnieuw opbouwen met reindex() na wijzigingen aan de velden hierboven
+    TransitionIndex Index;
+    EpsilonClosure Closure;
+
     explicit PDA(const string &filename);
 
+    void reindex();
+
+    bool isDeterministic() const;
+
+    // aanvaarden met lege stapel; deterministische PDA's worden in één pass uitgevoerd,
+    // de andere gesimuleerd met de voorberekende epsilon-afsluiting
+    bool accepts(const string &input) const;
+
+    // vanaf zoveel producties wordt toCFG over meerdere threads verdeeld
+    size_t ParallelThreshold = 1 << 15;
+
     CFG toCFG();
+
+    // zelfde grammatica als toCFG, maar meteen als JSON naar de stream zonder ze in het geheugen op te bouwen
+    void writeCFG(ostream &out) const;
+    void saveCFG(const string &filename) const;
+
+private:
+    // aantal producties van één transitie: 1, |Q| of |Q|² (niets bij een langere replacement)
+    size_t productionCount(const CodedTransition &trans) const;
+    // schrijft precies productionCount(trans) producties vanaf out; states zijn de gedeclareerde States als Index-nummers
+    void transitionProductions(const CodedTransition &trans, span<const uint32_t> states, Production *out) const;
+    string tripleName(uint32_t code) const;
 };
 
 
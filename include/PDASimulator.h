@@ -0,0 +1,64 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_PDASIMULATOR_H
+#define MB_PROGRAMMEEROPDRACHTEN_PDASIMULATOR_H
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "EpsilonClosure.h"
+#include "TransitionIndex.h"
+
+using namespace std;
+
+// Simuleert een niet-deterministische PDA (aanvaarden met lege stapel) over alle configuraties tegelijk.
+// Stapels worden gedeeld: een knoop is (symbool, knoop eronder) en gelijke knopen worden hergebruikt.
+// Epsilon-stappen gaan via de tabellen van EpsilonClosure; enkel configuraties die boven de Bound
+// van die tabellen uitkomen worden hier nog stap voor stap gevolgd.
+// Een stapelsymbool dat nergens met enkel epsilon-stappen kan verdwijnen kost minstens één invoersymbool,
+// dus configuraties met meer zulke symbolen dan er nog invoer over is worden meteen weggegooid.
+// Verder is er altijd een aanvaardende berekening waarvan de afleidingsboom (zie toCFG) hoogstens
+// (n+1)·|Q|²·|Γ| diep is, zodat hogere stapels dan dat maal de langste vervanging ook weg mogen.
+// MaxHeight is een optionele extra grens (0 = uit) voor grote automaten waar die afschatting niets oplevert;
+// die grens is niet veilig, dus als ze een configuratie wegsnijdt zegt limitHit() dat false "onbekend" betekent.
+// Automaten die met epsilon-stappen willekeurige stapels kunnen opbouwen blijven exponentieel;
+// daarvoor is toCFG() gevolgd door CFG::accepts de betere weg.
+class PDASimulator {
+public:
+    size_t MaxHeight = 0;
+
+    PDASimulator(const TransitionIndex &index, const EpsilonClosure &closure);
+
+    bool accepts(string_view input);
+    // heeft de laatste accepts() een configuratie weggegooid enkel door MaxHeight?
+    bool limitHit() const { return hit; }
+
+private:
+    struct Node {
+        int symbol;
+        int below;
+        size_t height;
+        size_t fixed;   // aantal niet-wisbare symbolen in de stapel
+    };
+    using Config = pair<int, int>; // (state, knoop), knoop -1 is de lege stapel
+
+    const TransitionIndex &index;
+    const EpsilonClosure &closure;
+
+    vector<Node> nodes;
+    unordered_map<uint64_t, int> nodeIds;
+    vector<Config> current, next, todo;
+    unordered_set<uint64_t> inNext;
+    size_t remaining = 0;
+    size_t heightLimit = 0;
+    bool capped = false;
+    bool hit = false;
+    size_t longestReplacement = 1;
+
+    int push(int below, span<const int> word);
+    void add(int state, int node, bool open);
+    void close();
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_PDASIMULATOR_H
@@ -0,0 +1,77 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_PARSERESULT_H
+#define MB_PROGRAMMEEROPDRACHTEN_PARSERESULT_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "Bits.h"
+#include "CompiledGrammar.h"
+#include "CYKTable.h"
+
+using namespace std;
+
+// Resultaat van één parse dat de CYK-tabel bijhoudt, zodat achteraf zonder opnieuw te parsen gevraagd
+// kan worden welke variabelen welk stuk van de invoer afleiden. Stukken zijn halfopen: [i, j) is
+// input[i .. j-1]. De grammatica moet blijven bestaan zolang het resultaat gebruikt wordt (of via keep
+// meegegeven worden). Zonder tabel (dropTable) blijven enkel accepted en elapsed over.
+class ParseResult {
+public:
+    bool accepted = false;
+    // tijd voor het compileren en parsen
+    chrono::nanoseconds elapsed{0};
+
+    ParseResult() = default;
+    ParseResult(const CompiledGrammar &grammar, CYKTable table, bool accepted);
+
+    // de grammatica in leven houden zolang dit resultaat bestaat
+    void keep(shared_ptr<const CompiledGrammar> grammar) { owner = std::move(grammar); }
+    // tabel weggooien, er is dan geen enkel stuk meer op te vragen
+    void dropTable();
+    bool hasTable() const { return tableKept; }
+
+    size_t length() const { return cells.n; }
+    const CompiledGrammar &grammar() const { return *rules; }
+    const CYKTable &table() const { return cells; }
+
+    // O(1): leidt A het stuk [i, j) af (false voor een leeg of ongeldig stuk)
+    bool derives(uint32_t A, size_t i, size_t j) const {
+        return i < j && j <= cells.n && A < rules->variableCount() && testBit(cells.cell(j - i, i), A);
+    }
+    bool derives(string_view variable, size_t i, size_t j) const;
+
+    // bitset over de variabelen (grammar().words() woorden) voor [i, j), nullptr voor een ongeldig stuk
+    const uint64_t *variables(size_t i, size_t j) const {
+        return i < j && j <= cells.n ? cells.cell(j - i, i) : nullptr;
+    }
+    // namen van de variabelen voor [i, j), alfabetisch
+    vector<string_view> variableNames(size_t i, size_t j) const;
+
+    // visit(A) voor elke variabele die [i, j) afleidt, oplopend
+    template<typename F>
+    void forEachVariable(size_t i, size_t j, F visit) const {
+        if (const uint64_t *set = variables(i, j)) forEachBit(set, cells.words, visit);
+    }
+
+    // visit(i, j) voor elk stuk dat A afleidt, per lengte oplopend en daarin per begin
+    template<typename F>
+    void forEachSpan(uint32_t A, F visit) const {
+        if (!rules || A >= rules->variableCount()) return;
+        for (size_t length = 1; length <= cells.n; ++length) {
+            for (size_t start = 0; start + length <= cells.n; ++start) {
+                if (testBit(cells.cell(length, start), A)) visit(start, start + length);
+            }
+        }
+    }
+    vector<pair<size_t, size_t>> spans(uint32_t A) const;
+
+private:
+    const CompiledGrammar *rules = nullptr;
+    shared_ptr<const CompiledGrammar> owner;
+    CYKTable cells;
+    bool tableKept = false;
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_PARSERESULT_H
@@ -0,0 +1,200 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_PRODUCTIONTABLE_H
+#define MB_PROGRAMMEEROPDRACHTEN_PRODUCTIONTABLE_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Producties van een CFG in CSR-vorm. Elk symbool (X of [p,X,q]) krijgt één keer een nummer; een regel is
+// (head, begin en lengte van de body in één doorlopende rij nummers). Na compact() staan de regels per head
+// na elkaar, met de heads in de volgorde van de vroegere map<vector<string>, ...> en binnen een head in
+// de volgorde waarin ze toegevoegd zijn.
+//
+// Vroeger was een body een lijst van delen (vector<vector<string>>): uit JSON één deel met alle symbolen,
+// uit toCFG één deel per symbool. grouped onthoudt welke vorm het was, zodat print en write hetzelfde
+// blijven. Code die P nog als map gebruikt kan P[head].push_back(body), empty() en een for-lus over
+// (head, bodies) blijven gebruiken; dat gaat via de oude vorm en is dus trager.
+class ProductionTable {
+    // heads in volgorde, per head het begin in order, en order = de regels per head
+    struct Grouping {
+        vector<uint32_t> heads;
+        vector<uint32_t> headStart;
+        vector<uint32_t> order;
+    };
+
+public:
+    struct Rule {
+        uint32_t head;
+        uint32_t bodyStart;
+        uint32_t bodyLength;
+        bool grouped;
+    };
+    using Legacy = map<vector<string>, vector<vector<vector<string>>>>;
+
+    // nummer van een symbool, nieuw als het nog niet bestaat
+    uint32_t symbol(const vector<string> &parts);
+    uint32_t symbol(const string &name);
+    size_t symbolCount() const { return symbols.size() + tripleCount(); }
+
+    // de strings van een symbool; voor een triple worden ze pas hier gemaakt
+    vector<string> parts(uint32_t id) const;
+    size_t partCount(uint32_t id) const { return isTriple(id) ? 3 : symbols[plain(id)].size(); }
+    // naam zoals CFG::print ze toont: X of [p,X,q]
+    string name(uint32_t id) const;
+    // visit(const string &) voor elk deel, zonder kopieën
+    template<typename F>
+    void forEachPart(uint32_t id, F visit) const {
+        if (isTriple(id)) {
+            uint32_t code = id - tripleBase;
+            const uint32_t q = code % tripleStates.size();
+            code /= tripleStates.size();
+            visit(tripleStates[code / tripleStack.size()]);
+            visit(tripleStack[code % tripleStack.size()]);
+            visit(tripleStates[q]);
+        } else {
+            for (const auto &part : symbols[plain(id)]) visit(part);
+        }
+    }
+
+    // Variabelen [p,X,q] van toCFG zonder ze op te zoeken of als strings te bewaren: alle combinaties
+    // van states × stapelsymbolen × states krijgen samen een blok nummers, [p,X,q] is
+    //     tripleBase + (p·|Γ| + X)·|Q| + q
+    // met p, X en q de indices in de gegeven lijsten. Kan maar één keer per tabel. false als er niets
+    // toegevoegd is: al eerder gedaan, of het blok past niet meer in de 32-bit nummers (dan zouden
+    // triples met gewone symbolen botsen).
+    bool addTriples(const vector<string> &states, const vector<string> &stackSymbols);
+    uint32_t triple(uint32_t p, uint32_t X, uint32_t q) const {
+        return tripleBase + (p * static_cast<uint32_t>(tripleStack.size()) + X) * static_cast<uint32_t>(tripleStates.size()) + q;
+    }
+    // met de code (p·|Γ| + X)·|Q| + q al berekend
+    uint32_t triple(uint32_t code) const { return tripleBase + code; }
+
+    void add(uint32_t head, span<const uint32_t> body, bool grouped);
+    // in de oude vorm: één deel wordt een grouped regel, anders is elk deel een symbool
+    void add(const vector<string> &head, const vector<vector<string>> &body);
+    // regels per head groeperen; zonder compact werkt alles nog, maar moet elke lezer eerst zelf groeperen
+    void compact();
+    void clear();
+    void reserve(size_t ruleCount, size_t bodySymbols);
+
+    // Verandert bij het aanmaken, kopiëren of leegmaken van de tabel; regels toevoegen verhoogt enkel
+    // ruleCount(). Samen herkennen ze dus elke wijziging, zonder per add een atomische teller.
+    uint64_t revision() const { return stamp.id; }
+
+    size_t ruleCount() const { return rules.size(); }
+    const Rule &rule(uint32_t r) const { return rules[r]; }
+    span<const uint32_t> body(const Rule &rule) const {
+        return {bodies.data() + rule.bodyStart, rule.bodyLength};
+    }
+    // aantal delen van de body in de oude vorm
+    size_t partCount(const Rule &rule) const { return rule.grouped ? 1 : rule.bodyLength; }
+    vector<vector<string>> legacyBody(const Rule &rule) const;
+
+    // visit(head, regels) per head in map-volgorde, met de regels als indices voor rule()
+    template<typename F>
+    void forEachHead(F visit) const {
+        shared_ptr<const Grouping> local = grouped();
+        for (size_t h = 0; h < local->heads.size(); ++h) {
+            visit(local->heads[h], span<const uint32_t>(local->order.data() + local->headStart[h],
+                                                        local->headStart[h + 1] - local->headStart[h]));
+        }
+    }
+
+    // --- adapter met de interface van de oude map ---
+    class Bodies {
+    public:
+        void push_back(const vector<vector<string>> &body) { table.add(head, body); }
+
+    private:
+        friend class ProductionTable;
+        Bodies(ProductionTable &table, const vector<string> &head) : table(table), head(head) {}
+        ProductionTable &table;
+        vector<string> head;
+    };
+
+    class const_iterator {
+    public:
+        Legacy::value_type operator*() const;
+        const_iterator &operator++() {
+            ++index;
+            return *this;
+        }
+        bool operator!=(const const_iterator &other) const { return index != other.index; }
+        bool operator==(const const_iterator &other) const { return index == other.index; }
+
+    private:
+        friend class ProductionTable;
+        const ProductionTable *table = nullptr;
+        shared_ptr<const Grouping> grouping;
+        size_t index = 0;
+    };
+
+    Bodies operator[](const vector<string> &head) { return Bodies(*this, head); }
+    bool empty() const { return rules.empty(); }
+    // aantal verschillende heads
+    size_t size() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+    Legacy legacy() const;
+
+private:
+    // uniek nummer uit één globale teller; een kopie krijgt een nieuw
+    struct Stamp {
+        uint64_t id = next();
+        Stamp() = default;
+        Stamp(const Stamp &) : id(next()) {}
+        Stamp &operator=(const Stamp &) {
+            id = next();
+            return *this;
+        }
+        static uint64_t next();
+    };
+
+    Stamp stamp;
+    // gewone symbolen; hun nummers slaan het blok van de triples over
+    vector<vector<string>> symbols;
+    unordered_map<string, uint32_t> symbolIds;
+    uint32_t tripleBase = 0;
+    vector<string> tripleStates;
+    vector<string> tripleStack;
+    unordered_map<string, uint32_t> tripleStateIds;
+    unordered_map<string, uint32_t> tripleStackIds;
+    vector<Rule> rules;
+    vector<uint32_t> bodies;
+    // null zodra er na compact() nog iets toegevoegd is
+    shared_ptr<const Grouping> grouping;
+    // zonder compact: group() één keer berekend tot de volgende add, zodat begin(), end() en size()
+    // in een lus niet telkens opnieuw groeperen; een kopie begint zonder
+    struct LazyGrouping {
+        mutex lock;
+        shared_ptr<const Grouping> grouping;
+
+        LazyGrouping() = default;
+        LazyGrouping(const LazyGrouping &) {}
+        LazyGrouping &operator=(const LazyGrouping &) {
+            grouping.reset();
+            return *this;
+        }
+    };
+    mutable LazyGrouping lazy;
+
+    size_t tripleCount() const { return tripleStates.size() * tripleStack.size() * tripleStates.size(); }
+    bool isTriple(uint32_t id) const { return id >= tripleBase && id - tripleBase < tripleCount(); }
+    // index in symbols van een gewoon symbool, en omgekeerd
+    size_t plain(uint32_t id) const { return id < tripleBase ? id : id - tripleCount(); }
+    uint32_t plainId(size_t index) const { return static_cast<uint32_t>(index < tripleBase ? index : index + tripleCount()); }
+
+    shared_ptr<const Grouping> group() const;
+    // grouping na compact(), anders de gecachete group()
+    shared_ptr<const Grouping> grouped() const;
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_PRODUCTIONTABLE_H
@@ -0,0 +1,74 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_RESULTCACHE_H
+#define MB_PROGRAMMEEROPDRACHTEN_RESULTCACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "GrammarRegistry.h"
+
+using namespace std;
+
+// Begrensde cache voor herhaalde vragen "aanvaardt deze grammatica deze invoer?".
+// De sleutel is (CompiledGrammar::serial(), hash van de invoer). Dat nummer is uniek in het hele proces,
+// dus meerdere registries (of losse grammatica's) kunnen één cache delen. Bij een treffer worden ook het
+// nummer en de volledige invoer vergeleken, dus een botsing van hashes geeft nooit een fout antwoord. Verdelen over shards met
+// elk een eigen mutex, zodat threads elkaar zelden blokkeren; binnen een shard vervangt CLOCK het
+// eerste item dat sinds de vorige ronde niet meer gebruikt is.
+class ResultCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+
+    // capacity 0 = uit: elke vraag is een miss en er wordt niets bewaard
+    explicit ResultCache(size_t capacity, size_t shards = 16);
+
+    ResultCache(const ResultCache &) = delete;
+    ResultCache &operator=(const ResultCache &) = delete;
+
+    optional<bool> find(const CompiledGrammar &grammar, string_view input);
+    void insert(const CompiledGrammar &grammar, string_view input, bool accepted);
+
+    // uit de cache, of anders met de CYKParser van deze thread (hergebruikt zolang het dezelfde grammatica is)
+    bool accepts(const CompiledGrammar &grammar, string_view input);
+    bool accepts(const GrammarRegistry::Version &version, string_view input) { return accepts(version.grammar, input); }
+
+    Stats stats() const;
+    size_t capacity() const;
+    void clear();
+
+private:
+    struct Entry {
+        uint64_t hash = 0;
+        uint64_t grammar = 0;
+        string input;
+        bool accepted = false;
+        bool referenced = false;
+        bool used = false;
+    };
+
+    struct Shard {
+        mutex lock;
+        vector<Entry> slots;
+        unordered_map<uint64_t, uint32_t> index;
+        size_t hand = 0;
+    };
+
+    vector<unique_ptr<Shard>> shards;
+    atomic<uint64_t> hits{0};
+    atomic<uint64_t> misses{0};
+    atomic<uint64_t> evictions{0};
+
+    static uint64_t key(uint64_t grammar, string_view input);
+    Shard &shardOf(uint64_t hash) { return *shards[(hash >> 32) % shards.size()]; }
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_RESULTCACHE_H
@@ -0,0 +1,42 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_TABLERENDERER_H
+#define MB_PROGRAMMEEROPDRACHTEN_TABLERENDERER_H
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "ParseResult.h"
+
+using namespace std;
+
+// Toont een ParseResult in één van drie vormen, telkens rij per rij (lengte n tot 1):
+//  - Text: zoals CFG::accepts vroeger printte, "| {A, B}  " per cel en "|" per rij, daarna true of false
+//  - JSON: {"accepted": ..., "length": n, "rows": [[["A", "B"], ...], ...]} op één lijn
+//  - HTML: een volledige pagina met de tabel, zonder externe bestanden
+// Alles gaat eerst in één buffer die naar de stream gaat zodra hij vol is, dus een grote tabel hoeft nooit
+// volledig als tekst in het geheugen te staan. Een resultaat zonder tabel toont enkel of het aanvaard is.
+class TableRenderer {
+public:
+    enum Format { Text, JSON, HTML };
+
+    // grootte waarboven de buffer naar de stream geschreven wordt
+    size_t FlushSize = 1 << 16;
+
+    explicit TableRenderer(ostream &out, Format format = Text);
+
+    void render(const ParseResult &result);
+
+private:
+    ostream &out;
+    Format format;
+    string buffer;
+
+    void renderText(const ParseResult &result);
+    void renderJSON(const ParseResult &result);
+    void renderHTML(const ParseResult &result);
+
+    void escapeHTML(string_view text);
+    void flushIfFull();
+    void flush();
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_TABLERENDERER_H
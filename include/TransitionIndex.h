@@ -0,0 +1,87 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_TRANSITIONINDEX_H
+#define MB_PROGRAMMEEROPDRACHTEN_TRANSITIONINDEX_H
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class PDA;
+
+// Transitie met alle namen vervangen door getallen.
+struct CodedTransition {
+    int from;
+    int input;          // -1 = epsilon
+    int stacktop;
+    int to;
+    int replacementStart;
+    int replacementLength;
+    int source;         // positie in PDA::Transitions
+};
+
+// Gecompileerde transitietabel van een PDA: states, invoersymbolen en stapelsymbolen krijgen
+// een nummer en (state, input, stacktop) wijst rechtstreeks naar een aaneengesloten stuk transities.
+// Epsilon-transities zitten in een aparte tabel per (state, stacktop).
+class TransitionIndex {
+public:
+    vector<string> States;
+    vector<string> Inputs;
+    vector<string> StackSymbols;
+    int StartState = -1;
+    int StartStack = -1;
+
+    TransitionIndex() = default;
+    explicit TransitionIndex(const PDA &pda);
+
+    // uniek per opgebouwde index (kopieën delen het), zodat hergebruikte hulpstructuren weten of ze nog kloppen
+    uint64_t serial() const { return id; }
+
+    int stateId(const string &name) const;
+    int inputId(const string &name) const;
+    int stackId(const string &name) const;
+
+    // invoersymbool voor een byte uit de invoerstring, -1 als die niet in het alfabet zit
+    int inputOf(unsigned char c) const { return byteInput[c]; }
+
+    span<const CodedTransition> moves(int state, int input, int stacktop) const {
+        size_t key = (static_cast<size_t>(state) * Inputs.size() + input) * StackSymbols.size() + stacktop;
+        return {grouped.data() + moveStart[key], grouped.data() + moveStart[key + 1]};
+    }
+
+    span<const CodedTransition> epsilonMoves(int state, int stacktop) const {
+        size_t key = static_cast<size_t>(state) * StackSymbols.size() + stacktop;
+        return {epsilon.data() + epsilonStart[key], epsilon.data() + epsilonStart[key + 1]};
+    }
+
+    span<const int> replacement(const CodedTransition &t) const {
+        return {replacements.data() + t.replacementStart, static_cast<size_t>(t.replacementLength)};
+    }
+
+    // geen twee transities die tegelijk kunnen, ook niet een epsilon-transitie naast een gewone
+    bool isDeterministic() const { return deterministic; }
+
+    // alle transities in de volgorde van het bestand
+    const vector<CodedTransition> &transitions() const { return ordered; }
+
+private:
+    map<string, int> stateIds;
+    map<string, int> inputIds;
+    map<string, int> stackIds;
+    vector<CodedTransition> ordered;
+    vector<CodedTransition> grouped;
+    vector<CodedTransition> epsilon;
+    vector<int> moveStart;
+    vector<int> epsilonStart;
+    vector<int> replacements;
+    array<int, 256> byteInput{};
+    bool deterministic = true;
+    uint64_t id = 0;
+
+    bool checkDeterministic() const;
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_TRANSITIONINDEX_H
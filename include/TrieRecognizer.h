@@ -0,0 +1,50 @@
+#ifndef MB_PROGRAMMEEROPDRACHTEN_TRIERECOGNIZER_H
+#define MB_PROGRAMMEEROPDRACHTEN_TRIERECOGNIZER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CompiledGrammar.h"
+
+using namespace std;
+
+// CYK voor een batch invoer met gemeenschappelijke prefixen. De invoer wordt in een trie gezet en de
+// tabel wordt kolom per eindpositie opgebouwd (zoals GrammarSearch) langs de paden van de trie: een kolom
+// hangt enkel af van de tekens ervoor, dus een gedeeld prefix wordt maar één keer berekend en bij een
+// splitsing gaan de kinderen verder op dezelfde kolommen. Het werk groeit met het aantal knopen van de
+// trie in plaats van met de totale lengte van de invoer.
+// Zelfde semantiek als CYKParser: enkel A -> a en A -> B C.
+class TrieRecognizer {
+public:
+    explicit TrieRecognizer(const CompiledGrammar &grammar);
+
+    // resultaat[i] hoort bij inputs[i]
+    vector<bool> accepts(const vector<string> &inputs);
+
+    // aantal knopen (zonder de wortel) van de trie van de laatste batch, dus het aantal berekende kolommen
+    size_t nodeCount() const { return nodes.empty() ? 0 : nodes.size() - 1; }
+
+private:
+    struct Node {
+        uint32_t firstChild = 0;
+        uint32_t nextSibling = 0;
+        // eerste invoer die hier eindigt, de rest via nextInput; -1 = geen
+        int64_t firstInput = -1;
+        unsigned char byte = 0;
+    };
+
+    const CompiledGrammar &grammar;
+    vector<Node> nodes;
+    vector<int64_t> nextInput;
+    // kolom d (na d tekens) heeft cellen voor lengte 1..d; enkel de kolommen van het huidige pad zijn geldig
+    vector<uint64_t> columns;
+
+    uint64_t *cell(size_t depth, size_t length) {
+        return columns.data() + ((depth - 1) * depth / 2 + (length - 1)) * grammar.words();
+    }
+
+    void build(const vector<string> &inputs);
+    void column(size_t depth, unsigned char c);
+};
+
+#endif //MB_PROGRAMMEEROPDRACHTEN_TRIERECOGNIZER_H
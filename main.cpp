@@ -1,10 +1,13 @@
 #include "include/CFG.h"
+#include "include/TableRenderer.h"
+#include <iostream>
 
 using namespace std;
 
 int main() {
     CFG cfg("input-cyk1.json");
-    cfg.accepts("baaba"); //moet true geven
-    cfg.accepts("abba"); //moet false geven
+    TableRenderer renderer(cout);
+    renderer.render(cfg.accepts("baaba", true)); //moet true geven
+    renderer.render(cfg.accepts("abba", true)); //moet false geven
     return 0;
-}
\ No newline at end of file
+}
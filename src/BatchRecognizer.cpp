@@ -0,0 +1,77 @@
+#include "../include/BatchRecognizer.h"
+#include "../include/Bits.h"
+#include <algorithm>
+#include <map>
+
+BatchRecognizer::BatchRecognizer(const CompiledGrammar &grammar) : grammar(grammar) {}
+
+vector<bool> BatchRecognizer::accepts(const vector<string> &inputs) {
+    vector<bool> result(inputs.size(), false);
+
+    // per lengte de indices van de invoer, in volgorde
+    map<size_t, vector<size_t>> buckets;
+    for (size_t i = 0; i < inputs.size(); ++i) buckets[inputs[i].size()].push_back(i);
+
+    vector<string_view> group;
+    for (const auto &[length, indices] : buckets) {
+        for (size_t first = 0; first < indices.size(); first += Lanes) {
+            const size_t count = min(Lanes, indices.size() - first);
+            group.clear();
+            for (size_t l = 0; l < count; ++l) group.push_back(inputs[indices[first + l]]);
+
+            uint64_t accepted = acceptsGroup(group);
+            for (size_t l = 0; l < count; ++l) {
+                if ((accepted >> l) & 1) result[indices[first + l]] = true;
+            }
+        }
+    }
+    return result;
+}
+
+uint64_t BatchRecognizer::acceptsGroup(span<const string_view> group) {
+    if (group.empty() || grammar.start() < 0) return 0;
+    const size_t n = group[0].size();
+    const size_t nV = grammar.variableCount();
+
+    // invoer die de voorfilter niet haalt doet niet mee
+    uint64_t active = 0;
+    for (size_t l = 0; l < group.size() && l < Lanes; ++l) {
+        if (group[l].size() == n && grammar.mayAccept(group[l])) active |= uint64_t(1) << l;
+    }
+    if (!active) return 0;
+    if (n == 0) return grammar.derivesEmpty() ? active : 0;
+
+    rowStart.resize(n + 2);
+    rowStart[1] = 0;
+    for (size_t len = 1; len <= n; ++len) rowStart[len + 1] = rowStart[len] + (n - len + 1);
+    lanes.assign(rowStart[n + 1] * nV, 0);
+
+    // Lijn 1: per invoer de variabelen van zijn byte op positie i
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t *base = cell(1, i);
+        for (uint64_t rest = active; rest; rest &= rest - 1) {
+            const int l = countr_zero(rest);
+            const uint64_t *vars = grammar.byteVariables(static_cast<unsigned char>(group[l][i]));
+            forEachBit(vars, grammar.words(), [&](uint32_t A) { base[A] |= uint64_t(1) << l; });
+        }
+    }
+
+    // Rest van de tabel: één AND/OR per regel en split voor alle invoer tegelijk
+    for (size_t length = 2; length <= n; ++length) {
+        if (!grammar.lengthPossible(length)) continue;
+        for (size_t start = 0; start + length <= n; ++start) {
+            uint64_t *target = cell(length, start);
+            for (size_t split = 1; split < length; ++split) {
+                const uint64_t *left = cell(split, start);
+                const uint64_t *right = cell(length - split, start + split);
+                for (uint32_t B = 0; B < nV; ++B) {
+                    if (!left[B]) continue;
+                    auto rules = grammar.binaryRules(B, length);
+                    for (size_t r = 0; r < rules.size(); r += 2) target[rules[r + 1]] |= left[B] & right[rules[r]];
+                }
+            }
+        }
+    }
+
+    return cell(n, 0)[grammar.start()] & active;
+}
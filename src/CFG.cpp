@@ -1,13 +1,62 @@
 #include "../include/CFG.h"
-#include "../json.hpp"
+#include "../include/CFGWriter.h"
+#include "../include/CYKParser.h"
+#include "../include/ParseResult.h"
+#include "../include/JSONSax.h"
 #include <fstream>
 #include <algorithm>
 #include <sstream>
 #include <iostream>
 #include <set>
+#include <chrono>
+#include <memory>
 
 using json = nlohmann::json;
 
+namespace {
+    // Vult de CFG terwijl het bestand gelezen wordt; elke productie gaat meteen in P.
+    class CFGSax : public JSONSax {
+    public:
+        explicit CFGSax(CFG &cfg) : cfg(cfg) {}
+
+    private:
+        CFG &cfg;
+        uint32_t head = 0;
+        vector<uint32_t> body;
+        bool hasHead = false;
+
+        void value(std::string &val) override {
+            if (depth == 1 && section == "Start") {
+                cfg.S = std::move(val);
+            } else if (depth == 2 && section == "Variables") {
+                // Each variable is a string, but we wrap it inside a vector<string>
+                cfg.V.push_back({std::move(val)});
+            } else if (depth == 2 && section == "Terminals") {
+                cfg.T.push_back(std::move(val));
+            } else if (depth == 3 && section == "Productions" && field == "head") {
+                head = cfg.P.symbol(val);
+                hasHead = true;
+            } else if (depth == 4 && section == "Productions" && field == "body") {
+                body.push_back(cfg.P.symbol(val));
+            }
+        }
+
+        void opened() override {
+            if (depth == 3 && section == "Productions") {
+                hasHead = false;
+                body.clear();
+                field.clear();
+            }
+        }
+
+        void closed() override {
+            if (depth != 3 || section != "Productions" || !hasHead) return;
+            // uit JSON is de body één deel met alle symbolen
+            cfg.P.add(head, body, true);
+        }
+    };
+}
+
 CFG::CFG(const string &filename) {
     std::ifstream input(filename);
     if (!input.is_open()) {
@@ -15,150 +64,319 @@ CFG::CFG(const string &filename) {
         return;
     }
 
-    json j;
-    input >> j;
+    CFGSax reader(*this);
+    if (!json::sax_parse(input, &reader)) {
+        std::cerr << "Fout: '" << filename << "' is geen geldige JSON: " << reader.error << std::endl;
+        *this = CFG();
+        return;
+    }
+    P.compact();
+}
 
-    // Variabelen (as vector<vector<string>>)
-    if (j.contains("Variables") && j["Variables"].is_array()) {
-        for (const auto &v : j["Variables"]) {
-            // Each variable is a string, but we wrap it inside a vector<string>
-            V.push_back({v.get<string>()});
-        }
+string symbolName(const vector<string> &symbol) {
+    if (symbol.size() == 1) return symbol[0];
+    string name = "[";
+    for (size_t i = 0; i < symbol.size(); ++i) {
+        if (i > 0) name += ",";
+        name += symbol[i];
+    }
+    return name + "]";
+}
+
+void CFG::forEachProduction(const function<void(const string &, const vector<string> &)> &visit) const {
+    // variabelen uit toCFG bestaan uit meerdere strings
+    set<vector<string>> grouped;
+    for (const auto &var : V) {
+        if (var.size() > 1) grouped.insert(var);
     }
 
-    // Terminals
-    if (j.contains("Terminals") && j["Terminals"].is_array()) {
-        for (const auto &t : j["Terminals"]) {
-            T.push_back(t.get<string>());
+    vector<string> symbols, single;
+    P.forEachHead([&](uint32_t head, span<const uint32_t> rules) {
+        string name = P.name(head);
+        for (uint32_t r : rules) {
+            const ProductionTable::Rule &rule = P.rule(r);
+            auto body = P.body(rule);
+            symbols.clear();
+            if (P.partCount(rule) == 1) {
+                // één deel: ofwel alle symbolen uit JSON, ofwel één variabele uit toCFG
+                single.clear();
+                for (uint32_t sym : body) P.forEachPart(sym, [&](const string &part) { single.push_back(part); });
+                if (grouped.count(single)) {
+                    symbols.push_back(symbolName(single));
+                } else {
+                    for (const auto &sym : single) {
+                        if (!sym.empty()) symbols.push_back(sym);
+                    }
+                }
+            } else {
+                // uit toCFG: elk deel is één symbool, een lege invoer is epsilon
+                for (uint32_t sym : body) {
+                    string text = P.name(sym);
+                    if (!text.empty()) symbols.push_back(text);
+                }
+            }
+            visit(name, symbols);
         }
+    });
+}
+
+void CFG::write(ostream &out) const {
+    CFGWriter writer(out);
+    for (const auto &var : V) writer.variable(symbolName(var));
+    for (const auto &t : T) writer.terminal(t);
+    forEachProduction([&](const string &head, const vector<string> &body) {
+        writer.production(head, body);
+    });
+    writer.start(S);
+}
+
+void CFG::save(const string &filename) const {
+    std::ofstream output(filename);
+    if (!output.is_open()) {
+        std::cerr << "Fout: kon bestand '" << filename << "' niet schrijven." << std::endl;
+        return;
     }
+    write(output);
+}
 
-    // Producties
-    if (j.contains("Productions") && j["Productions"].is_array()) {
-        for (const auto &prod : j["Productions"]) {
-            string head = prod["head"].get<string>();
-            vector<string> body;
+namespace {
+    // Schrijft naar een stream in blokken van ChunkSize, zodat de uitvoer nooit volledig in het geheugen staat
+    class ChunkedWriter {
+    public:
+        static const size_t ChunkSize = 1 << 16;
 
-            if (prod.contains("body") && prod["body"].is_array()) {
-                for (const auto &sym : prod["body"]) {
-                    body.push_back(sym.get<string>());
-                }
+        explicit ChunkedWriter(ostream &out) : out(out) { buffer.reserve(ChunkSize + 256); }
+        ~ChunkedWriter() { flush(); }
+
+        ChunkedWriter &operator<<(string_view text) {
+            buffer += text;
+            if (buffer.size() >= ChunkSize) flush();
+            return *this;
+        }
+
+        void flush() {
+            out.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+            buffer.clear();
+        }
+
+    private:
+        ostream &out;
+        string buffer;
+    };
+
+    // Rang van elke string die in een sorteersleutel voorkomt: strings vergelijken wordt dan getallen vergelijken.
+    // Een sleutel is een reeks rangen in keys, aangeduid met (begin, lengte).
+    struct SortKeys {
+        vector<string_view> names;
+        vector<uint32_t> keys;
+
+        void collect(string_view name) { names.push_back(name); }
+
+        void finish() {
+            sort(names.begin(), names.end());
+            names.erase(unique(names.begin(), names.end()), names.end());
+        }
+
+        uint32_t rank(string_view name) const {
+            return static_cast<uint32_t>(lower_bound(names.begin(), names.end(), name) - names.begin());
+        }
+
+        pair<uint32_t, uint32_t> add(const vector<string> &symbols) {
+            uint32_t begin = static_cast<uint32_t>(keys.size());
+            for (const auto &sym : symbols) keys.push_back(rank(sym));
+            return {begin, static_cast<uint32_t>(symbols.size())};
+        }
+
+        // zelfde volgorde als de ASCII-vergelijking per element en dan de lengte
+        int compare(pair<uint32_t, uint32_t> a, pair<uint32_t, uint32_t> b) const {
+            for (uint32_t i = 0; i < min(a.second, b.second); ++i) {
+                if (keys[a.first + i] != keys[b.first + i]) return keys[a.first + i] < keys[b.first + i] ? -1 : 1;
             }
+            return 0;
+        }
+    };
 
-            // Now we wrap both the head and body in extra vectors to match your map type
-            P[{head}].push_back({body});
+    void writeSymbol(ChunkedWriter &out, const vector<string> &symbol) {
+        if (symbol.size() == 1) {
+            out << symbol[0];
+            return;
         }
+        out << "[";
+        for (size_t j = 0; j < symbol.size(); ++j) {
+            out << symbol[j];
+            if (j + 1 != symbol.size()) out << ",";
+        }
+        out << "]";
     }
 
-    // Startsymbool
-    if (j.contains("Start")) {
-        S = j["Start"].get<string>();
+    // zelfde als hierboven voor een symbool uit de ProductionTable, zonder zijn delen te kopiëren
+    void writeSymbol(ChunkedWriter &out, const ProductionTable &table, uint32_t id) {
+        const bool single = table.partCount(id) == 1;
+        if (!single) out << "[";
+        bool first = true;
+        table.forEachPart(id, [&](const string &part) {
+            if (!first) out << ",";
+            out << part;
+            first = false;
+        });
+        if (!single) out << "]";
     }
 }
 
 void CFG::print() const {
-    std::ostringstream out;
+    print(std::cout);
+    std::cout.flush();
+}
+
+// Zelfde uitvoer als altijd, maar er worden enkel indices gesorteerd (met std::sort en dezelfde vergelijking,
+// dus ook gelijke elementen komen in dezelfde volgorde) en de tekst gaat in blokken naar de stream.
+void CFG::print(ostream &stream) const {
+    ChunkedWriter out(stream);
+
+    // sorteersleutels: de variabelen, de heads en van elke body het eerste deel
+    SortKeys sortKeys;
+    for (const auto &var : V) {
+        for (const auto &part : var) sortKeys.collect(part);
+    }
+    // enkel de symbolen die in een regel staan; de meeste triples van toCFG komen nergens voor
+    vector<uint32_t> used;
+    for (uint32_t r = 0; r < P.ruleCount(); ++r) {
+        const ProductionTable::Rule &rule = P.rule(r);
+        used.push_back(rule.head);
+        for (uint32_t sym : P.body(rule)) used.push_back(sym);
+    }
+    std::sort(used.begin(), used.end());
+    used.erase(unique(used.begin(), used.end()), used.end());
+    for (uint32_t id : used) P.forEachPart(id, [&](const string &part) { sortKeys.collect(part); });
+    sortKeys.finish();
 
     // --- V ---
     out << "V = {";
-    auto sortedV = V;
-    std::sort(sortedV.begin(), sortedV.end(), [](const std::vector<std::string> &a, const std::vector<std::string> &b) {
-        for (size_t i = 0; i < std::min(a.size(), b.size()); ++i) {
-            if (a[i] != b[i])
-                return a[i] < b[i]; // ASCII-vergelijking
-        }
-        return a.size() < b.size();
+    vector<pair<uint32_t, uint32_t>> varKeys;
+    for (const auto &var : V) varKeys.push_back(sortKeys.add(var));
+    vector<uint32_t> order(V.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        int c = sortKeys.compare(varKeys[a], varKeys[b]);
+        return c != 0 ? c < 0 : varKeys[a].second < varKeys[b].second;
     });
-    for (size_t i = 0; i < sortedV.size(); i++) {
-        const auto &var = sortedV[i];
-        if (var.size() == 1) {
-            out << var[0];
-        } else {
-            out << "[";
-            for (size_t j = 0; j < var.size(); ++j) {
-                out << var[j];
-                if (j + 1 != var.size()) out << ",";
-            }
-            out << "]";
-        }
-        if (i + 1 != sortedV.size()) out << ", ";
+    for (size_t i = 0; i < order.size(); i++) {
+        writeSymbol(out, V[order[i]]);
+        if (i + 1 != order.size()) out << ", ";
     }
     out << "}\n";
 
     // --- T ---
     out << "T = {";
-    auto sortedT = T;
-    std::sort(sortedT.begin(), sortedT.end());
-    for (size_t i = 0; i < sortedT.size(); i++) {
-        out << sortedT[i];
-        if (i + 1 != sortedT.size()) out << ", ";
+    vector<uint32_t> terminalOrder(T.size());
+    for (uint32_t i = 0; i < terminalOrder.size(); ++i) terminalOrder[i] = i;
+    std::sort(terminalOrder.begin(), terminalOrder.end(), [&](uint32_t a, uint32_t b) { return T[a] < T[b]; });
+    for (size_t i = 0; i < terminalOrder.size(); i++) {
+        out << T[terminalOrder[i]];
+        if (i + 1 != terminalOrder.size()) out << ", ";
     }
     out << "}\n";
 
     // --- P ---
     out << "P = {\n";
 
-    // Sort keys ASCII-style
-    std::vector<std::vector<std::string>> sortedKeys;
-    for (const auto &pair : P) sortedKeys.push_back(pair.first);
-    std::sort(sortedKeys.begin(), sortedKeys.end(), [](const std::vector<std::string> &a, const std::vector<std::string> &b) {
-        for (size_t i = 0; i < std::min(a.size(), b.size()); ++i) {
-            if (a[i] != b[i])
-                return a[i] < b[i]; // ASCII compare
-        }
-        return a.size() < b.size();
+    // Sort keys ASCII-style; de sleutel van elk symbool wordt één keer berekend
+    // parallel aan used; symbolKey zoekt de positie van een symbool op
+    vector<pair<uint32_t, uint32_t>> symbolKeys(used.size());
+    for (size_t i = 0; i < used.size(); ++i) {
+        uint32_t begin = static_cast<uint32_t>(sortKeys.keys.size());
+        P.forEachPart(used[i], [&](const string &part) { sortKeys.keys.push_back(sortKeys.rank(part)); });
+        symbolKeys[i] = {begin, static_cast<uint32_t>(sortKeys.keys.size()) - begin};
+    }
+    auto symbolKey = [&](uint32_t id) { return symbolKeys[lower_bound(used.begin(), used.end(), id) - used.begin()]; };
+
+    vector<uint32_t> heads, headStart{0}, ruleList;
+    vector<pair<uint32_t, uint32_t>> headKeys;
+    P.forEachHead([&](uint32_t head, span<const uint32_t> rules) {
+        heads.push_back(head);
+        headKeys.push_back(symbolKey(head));
+        ruleList.insert(ruleList.end(), rules.begin(), rules.end());
+        headStart.push_back(static_cast<uint32_t>(ruleList.size()));
+    });
+    order.resize(heads.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        const auto &keyA = headKeys[a], &keyB = headKeys[b];
+        int c = sortKeys.compare(keyA, keyB);
+        return c != 0 ? c < 0 : keyA.second < keyB.second;
     });
 
     // Print each production
-    for (const auto &key : sortedKeys) {
-        auto it = P.find(key);
-        if (it == P.end()) continue;
-        const auto &productions = it->second;
-
-        // sort bodies inside each key (optional but consistent)
-        auto sortedProductions = productions;
-        std::sort(sortedProductions.begin(), sortedProductions.end(), [](const std::vector<std::vector<std::string>> &a,
-                                                                         const std::vector<std::vector<std::string>> &b) {
-            if (a.empty() || b.empty()) return a.size() < b.size();
-            for (size_t i = 0; i < std::min(a[0].size(), b[0].size()); ++i) {
-                if (a[0][i] != b[0][i])
-                    return a[0][i] < b[0][i];
+    vector<pair<uint32_t, uint32_t>> bodyKeys;
+    vector<uint32_t> bodyOrder;
+    for (uint32_t h : order) {
+        const vector<string> &key = P.parts(heads[h]);
+        span<const uint32_t> productions(ruleList.data() + headStart[h], headStart[h + 1] - headStart[h]);
+
+        // sort bodies inside each key (optional but consistent); de sleutel is het eerste deel van de body
+        const size_t mark = sortKeys.keys.size();
+        bodyKeys.clear();
+        for (uint32_t r : productions) {
+            const ProductionTable::Rule &rule = P.rule(r);
+            auto body = P.body(rule);
+            if (rule.grouped) {
+                uint32_t begin = static_cast<uint32_t>(sortKeys.keys.size());
+                for (uint32_t sym : body) {
+                    auto [first, length] = symbolKey(sym);
+                    for (uint32_t k = first; k < first + length; ++k) {
+                        uint32_t rank = sortKeys.keys[k];
+                        sortKeys.keys.push_back(rank);
+                    }
+                }
+                bodyKeys.push_back({begin, static_cast<uint32_t>(sortKeys.keys.size()) - begin});
+            } else {
+                bodyKeys.push_back(body.empty() ? pair<uint32_t, uint32_t>{0, 0} : symbolKey(body[0]));
             }
-            return a.size() < b.size();
+        }
+        bodyOrder.resize(productions.size());
+        for (uint32_t i = 0; i < bodyOrder.size(); ++i) bodyOrder[i] = i;
+        std::sort(bodyOrder.begin(), bodyOrder.end(), [&](uint32_t a, uint32_t b) {
+            const size_t sizeA = P.partCount(P.rule(productions[a])), sizeB = P.partCount(P.rule(productions[b]));
+            if (sizeA == 0 || sizeB == 0) return sizeA < sizeB;
+            int c = sortKeys.compare(bodyKeys[a], bodyKeys[b]);
+            return c != 0 ? c < 0 : sizeA < sizeB;
         });
+        sortKeys.keys.resize(mark);
 
-        for (const auto &bodySet : sortedProductions) {
-            // left-hand side
-            out << "    ";
-            if (key.size() == 1) {
-                out << key[0];
-                if (key[0].size() < 3) out << "   ";
-                else out << " ";
-            } else {
-                out << "[";
-                for (size_t j = 0; j < key.size(); ++j) {
-                    out << key[j];
-                    if (j + 1 != key.size()) out << ",";
+        // left-hand side, voor elke body van deze key hetzelfde
+        string lhs = "    ";
+        if (key.size() == 1) {
+            lhs += key[0];
+            lhs += key[0].size() < 3 ? "   " : " ";
+        } else {
+            lhs += symbolName(key) + "  ";
+            if (key.size() == 3) lhs += " ";
+        }
+        lhs += "-> `";
+
+        for (uint32_t b : bodyOrder) {
+            const ProductionTable::Rule &rule = P.rule(productions[b]);
+            auto body = P.body(rule);
+            out << lhs;
+
+            // right-hand side; uit JSON is de body één deel met alle symbolen
+            if (rule.grouped) {
+                size_t strings = 0;
+                for (uint32_t sym : body) strings += P.partCount(sym);
+                if (strings != 1) out << "[";
+                bool first = true;
+                for (uint32_t sym : body) {
+                    P.forEachPart(sym, [&](const string &part) {
+                        if (!first) out << ",";
+                        out << part;
+                        first = false;
+                    });
                 }
-                out << "]  ";
-                if (key.size() == 3) out << " ";
-            }
-
-            out << "-> `";
-
-            // right-hand side
-            for (size_t j = 0; j < bodySet.size(); ++j) {
-                const auto &part = bodySet[j];
-                if (j > 0) out << " ";
-                if (part.size() == 1) {
-                    out << part[0];
-                } else {
-                    out << "[";
-                    for (size_t k = 0; k < part.size(); ++k) {
-                        out << part[k];
-                        if (k + 1 != part.size()) out << ",";
-                    }
-                    out << "]";
+                if (strings != 1) out << "]";
+            } else {
+                for (size_t j = 0; j < body.size(); ++j) {
+                    if (j > 0) out << " ";
+                    writeSymbol(out, P, body[j]);
                 }
             }
             out << "`\n";
@@ -168,9 +386,7 @@ void CFG::print() const {
     out << "}\n";
 
     // --- S ---
-    out << "S = " << S;
-
-    std::cout << out.str() << std::endl;
+    out << "S = " << S << "\n";
 }
 
 // void CFG::accepts(string input) {
@@ -249,99 +465,33 @@ void CFG::print() const {
 //     cout << (accepted ? "true" : "false") << endl;
 // }
 
-void CFG::accepts(string input) {
-    // splits input up letter per letter
-    vector<string> inputChar;
-    for (char c : input) {
-        inputChar.emplace_back(1, c);
-    }
-
-    int n = inputChar.size();
-
-    // Maak de CYK tabel: CYK_table[length][start_pos]
-    vector<vector<vector<string>>> CYK_table(n);
-    for (int i = 0; i < n; ++i) {
-        CYK_table[i].resize(n - i);
-    }
-
-    // Lijn 1 van de CYK: vul de basis (lengte 1)
-    for (int _i = 0; _i < inputChar.size(); ++_i) {
-        for (const auto& transities : this->P) {
-            for (auto& trans : transities.second) {
-                // Check voor unit productie A -> a
-                if (trans.size() == 1 && trans[0].size() == 1 && trans[0][0] == inputChar[_i]) {
-                    CYK_table[0][_i].push_back(transities.first[0]);
-                }
-            }
-        }
-    }
-
-    // Vul de rest van de CYK tabel (lengtes 2 tot n)
-    for (int length = 2; length <= n; ++length) {
-        for (int start = 0; start <= n - length; ++start) {
-            // Voor elke mogelijke split van de substring
-            for (int split = 1; split < length; ++split) {
-                int left_length = split;
-                int right_length = length - split;
-                int right_start = start + split;
-
-                // Haal de linker en rechter delen op
-                vector<string>& left = CYK_table[left_length - 1][start];
-                vector<string>& right = CYK_table[right_length - 1][right_start];
-
-                // Maak combinaties van linker en rechter variabelen
-                vector<vector<string>> Combinaties;
-                for (int i = 0; i < left.size(); ++i) {
-                    for (int j = 0; j < right.size(); ++j) {
-                        vector<string> temp;
-                        temp.push_back(left[i]);
-                        temp.push_back(right[j]);
-                        Combinaties.push_back(temp);
-                    }
-                }
-
-                // Check welke producties deze combinaties kunnen maken
-                for (const auto& transities : this->P) {
-                    for (auto& trans : transities.second) {
-                        // Check voor binaire productie A -> BC
-                        if (trans.size() == 1 && trans[0].size() == 2) {
-                            string B = trans[0][0];
-                            string C = trans[0][1];
-
-                            // Vergelijk met alle combinaties
-                            for (int _i = 0; _i < Combinaties.size(); ++_i) {
-                                if (Combinaties[_i][0] == B && Combinaties[_i][1] == C) {
-                                    CYK_table[length - 1][start].push_back(transities.first[0]);
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
+shared_ptr<const CompiledGrammar> CFG::compiled() const {
+    lock_guard<mutex> guard(cache.lock);
+    if (!cache.grammar || cache.revision != P.revision() || cache.rules != P.ruleCount() || cache.start != S
+        || cache.variables != V || cache.terminals != T) {
+        cache.grammar = make_shared<const CompiledGrammar>(*this);
+        cache.revision = P.revision();
+        cache.rules = P.ruleCount();
+        cache.variables = V;
+        cache.terminals = T;
+        cache.start = S;
     }
+    return cache.grammar;
+}
 
-    // Print de CYK tabel
-    for (int length = n; length >= 1; --length) {
-        for (int start = 0; start <= n - length; ++start) {
-            cout << "| {";
-
-            // Sorteer en verwijder duplicaten
-            vector<string> vars = CYK_table[length - 1][start];
-            sort(vars.begin(), vars.end());
-            vars.erase(unique(vars.begin(), vars.end()), vars.end());
-
-            for (int i = 0; i < vars.size(); ++i) {
-                cout << vars[i];
-                if (i + 1 < vars.size()) cout << ", ";
-            }
-            cout << "}  ";
-        }
-        cout << "|\n";
+ParseResult CFG::accepts(const string &input, bool keepTable) const {
+    auto begin = chrono::steady_clock::now();
+    shared_ptr<const CompiledGrammar> grammar = compiled();
+    CYKParser parser(*grammar);
+
+    // parse vult altijd de volledige tabel; zonder tabel mag de voorfilter het werk overslaan
+    ParseResult result;
+    if (keepTable) {
+        result = parser.parse(input);
+    } else {
+        result.accepted = parser.accepts(input);
     }
-
-    // Check of het startsymbool in de top cel zit
-    vector<string>& top = CYK_table[n - 1][0];
-    bool accepted = find(top.begin(), top.end(), S) != top.end();
-    cout << (accepted ? "true" : "false") << endl;
+    result.keep(grammar);
+    result.elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin);
+    return result;
 }
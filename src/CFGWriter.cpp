@@ -0,0 +1,79 @@
+#include "../include/CFGWriter.h"
+
+void appendJSONString(string &into, string_view text) {
+    into += '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': into += "\\\""; break;
+            case '\\': into += "\\\\"; break;
+            case '\n': into += "\\n"; break;
+            case '\t': into += "\\t"; break;
+            case '\r': into += "\\r"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    const char *hex = "0123456789abcdef";
+                    into += "\\u00";
+                    into += hex[c >> 4];
+                    into += hex[c & 15];
+                } else {
+                    into += c;
+                }
+        }
+    }
+    into += '"';
+}
+
+CFGWriter::CFGWriter(ostream &out) : out(out) {
+    out << "{";
+}
+
+void CFGWriter::variable(const string &name) {
+    enter(Variables);
+    if (!first) out << ", ";
+    write(name);
+    first = false;
+}
+
+void CFGWriter::terminal(const string &name) {
+    enter(Terminals);
+    if (!first) out << ", ";
+    write(name);
+    first = false;
+}
+
+void CFGWriter::production(const string &head, const vector<string> &body) {
+    enter(Productions);
+    out << (first ? "\n    " : ",\n    ") << "{\"head\": ";
+    write(head);
+    out << ", \"body\": [";
+    for (size_t i = 0; i < body.size(); ++i) {
+        if (i > 0) out << ", ";
+        write(body[i]);
+    }
+    out << "]}";
+    first = false;
+}
+
+void CFGWriter::start(const string &name) {
+    enter(Done);
+    out << "\n  \"Start\": ";
+    write(name);
+    out << "\n}\n";
+}
+
+// secties die overgeslagen worden komen er als lege lijst in
+void CFGWriter::enter(Section next) {
+    static const char *names[] = {"", "Variables", "Terminals", "Productions"};
+    while (section < next) {
+        if (section != None) out << (section == Productions && !first ? "\n  ]," : "],");
+        section = static_cast<Section>(section + 1);
+        if (section != Done) out << "\n  \"" << names[section] << "\": [";
+        first = true;
+    }
+}
+
+void CFGWriter::write(const string &text) {
+    scratch.clear();
+    appendJSONString(scratch, text);
+    out << scratch;
+}
@@ -0,0 +1,150 @@
+#include "../include/CYKParser.h"
+#include "../include/Bits.h"
+#include <algorithm>
+#include <bit>
+
+CYKParser::CYKParser(const CompiledGrammar &grammar) : grammar(grammar) {}
+
+bool CYKParser::accepts(string_view input) {
+    const size_t n = input.size();
+    const size_t words = grammar.words();
+    cells.reset(n, words);
+    accepted = false;
+    pruned = false;
+    if (Prefilter && !grammar.mayAccept(input)) return false;
+
+    // Lijn 1 van de CYK: vul de basis (lengte 1), één opzoeking per invoersymbool
+    for (size_t i = 0; i < n; ++i) {
+        const uint64_t *vars = grammar.byteVariables(static_cast<unsigned char>(input[i]));
+        copy(vars, vars + words, cells.cell(1, i));
+    }
+
+    // Vul de rest van de CYK tabel (lengtes 2 tot n)
+    for (size_t length = 2; length <= n; ++length) {
+        // geen enkele kop kan deze lengte afleiden: de hele rij blijft leeg
+        if (!grammar.lengthPossible(length)) continue;
+        for (size_t start = 0; start + length <= n; ++start) {
+            uint64_t *cell = cells.cell(length, start);
+
+            // Voor elke mogelijke split van de substring: A -> B C met B links en C rechts
+            for (size_t split = 1; split < length; ++split) {
+                const uint64_t *left = cells.cell(split, start);
+                const uint64_t *right = cells.cell(length - split, start + split);
+                if (!anyBit(left, words) || !anyBit(right, words)) continue;
+
+                forEachBit(left, words, [&](uint32_t B) {
+                    auto rules = grammar.binaryRules(B, length);
+                    for (size_t r = 0; r < rules.size(); r += 2) {
+                        if (testBit(right, rules[r])) setBit(cell, rules[r + 1]);
+                    }
+                });
+            }
+        }
+    }
+
+    // Check of het startsymbool in de top cel zit
+    if (grammar.start() < 0) return false;
+    if (n == 0) return accepted = grammar.derivesEmpty();
+    return accepted = testBit(cells.cell(n, 0), grammar.start());
+}
+
+ParseResult CYKParser::parse(string_view input) {
+    // de voorfilter zou de tabel leeg laten, en die tabel is net wat een ParseResult moet tonen
+    const bool prefilter = Prefilter;
+    Prefilter = false;
+    bool result = accepts(input);
+    Prefilter = prefilter;
+    ParseResult parsed(grammar, std::move(cells), result);
+    // de tabel is weg: opnieuw een lege tabel, zodat table(), pruneToRoot() en derivations() niets ongeldigs lezen
+    cells = CYKTable();
+    cells.reset(0, grammar.words());
+    accepted = false;
+    pruned = false;
+    return parsed;
+}
+
+size_t CYKParser::pruneToRoot() {
+    const size_t n = cells.n;
+    const size_t words = cells.words;
+    useful.reset(n, words);
+    pruned = true;
+    if (!accepted || n == 0) return 0;
+
+    // S bovenaan, daarna per cel van lang naar kort: B links en C rechts zijn bruikbaar
+    // als er een A -> B C is met A bruikbaar in de cel erboven
+    setBit(useful.cell(n, 0), grammar.start());
+    size_t count = 0;
+    for (size_t length = n; length >= 1; --length) {
+        for (size_t start = 0; start + length <= n; ++start) {
+            const uint64_t *parent = useful.cell(length, start);
+            if (!anyBit(parent, words)) continue;
+            for (size_t w = 0; w < words; ++w) count += popcount(parent[w]);
+            if (length == 1) continue;
+
+            for (size_t split = 1; split < length; ++split) {
+                const uint64_t *left = cells.cell(split, start);
+                const uint64_t *right = cells.cell(length - split, start + split);
+                uint64_t *usedLeft = useful.cell(split, start);
+                uint64_t *usedRight = useful.cell(length - split, start + split);
+
+                forEachBit(left, words, [&](uint32_t B) {
+                    auto rules = grammar.binaryRules(B, length);
+                    for (size_t r = 0; r < rules.size(); r += 2) {
+                        if (!testBit(parent, rules[r + 1]) || !testBit(right, rules[r])) continue;
+                        setBit(usedLeft, B);
+                        setBit(usedRight, rules[r]);
+                    }
+                });
+            }
+        }
+    }
+    return count;
+}
+
+double CYKParser::derivations() {
+    if (!pruned) pruneToRoot();
+    const size_t n = cells.n;
+    const size_t words = cells.words;
+    if (!accepted) return 0;
+    if (n == 0) return 1;
+
+    // enkel een teller per bruikbare entry; index = plaats van de cel + rang van A binnen de cel
+    auto cellIndex = [&](size_t length, size_t start) { return (useful.cell(length, start) - useful.cell(1, 0)) / words; };
+    const size_t cellCount = cellIndex(n, 0) + 1;
+    vector<size_t> offset(cellCount + 1, 0);
+    for (size_t c = 0; c < cellCount; ++c) {
+        const uint64_t *set = useful.cell(1, 0) + c * words;
+        offset[c + 1] = offset[c];
+        for (size_t w = 0; w < words; ++w) offset[c + 1] += popcount(set[w]);
+    }
+    vector<double> total(offset[cellCount], 0);
+    auto slot = [&](size_t length, size_t start, uint32_t A) -> double & {
+        const uint64_t *set = useful.cell(length, start);
+        size_t rank = 0;
+        for (size_t w = 0; w < (A >> 6); ++w) rank += popcount(set[w]);
+        rank += popcount(set[A >> 6] & ((uint64_t(1) << (A & 63)) - 1));
+        return total[offset[cellIndex(length, start)] + rank];
+    };
+
+    for (size_t start = 0; start < n; ++start) {
+        forEachBit(useful.cell(1, start), words, [&](uint32_t A) { slot(1, start, A) = 1; });
+    }
+    for (size_t length = 2; length <= n; ++length) {
+        for (size_t start = 0; start + length <= n; ++start) {
+            const uint64_t *parent = useful.cell(length, start);
+            if (!anyBit(parent, words)) continue;
+            for (size_t split = 1; split < length; ++split) {
+                const uint64_t *usedRight = useful.cell(length - split, start + split);
+                forEachBit(useful.cell(split, start), words, [&](uint32_t B) {
+                    auto rules = grammar.binaryRules(B, length);
+                    for (size_t r = 0; r < rules.size(); r += 2) {
+                        if (!testBit(parent, rules[r + 1]) || !testBit(usedRight, rules[r])) continue;
+                        slot(length, start, rules[r + 1]) +=
+                                slot(split, start, B) * slot(length - split, start + split, rules[r]);
+                    }
+                });
+            }
+        }
+    }
+    return slot(n, 0, grammar.start());
+}
@@ -0,0 +1,375 @@
+#include "../include/CompiledGrammar.h"
+#include "../include/Bits.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <numeric>
+
+uint64_t CompiledGrammar::nextSerial() {
+    static atomic<uint64_t> counter{0};
+    return ++counter;
+}
+
+CompiledGrammar::CompiledGrammar(const CFG &cfg) : image(GrammarImage::fromCFG(cfg)) {
+    analyse();
+}
+
+CompiledGrammar::CompiledGrammar(GrammarImage image) : image(std::move(image)) {
+    // een bestand dat niet geladen kon worden wordt een lege grammatica die niets aanvaardt
+    if (!this->image.valid()) this->image = GrammarImage::fromCFG(CFG());
+    analyse();
+}
+
+void CompiledGrammar::analyse() {
+    byteTerminal.fill(-1);
+
+    const uint32_t nV = image.variableCount();
+    startId = image.start() == GrammarImage::None ? -1 : static_cast<int>(image.start());
+
+    byteSets.assign(256 * words(), 0);
+    for (uint32_t t = nV; t < image.symbolCount(); ++t) {
+        string_view terminal = image.name(t);
+        if (terminal.size() != 1) continue;
+        unsigned char c = static_cast<unsigned char>(terminal[0]);
+        byteTerminal[c] = static_cast<int>(t);
+        for (uint32_t A : image.unitHeads(t)) setBit(byteSets.data() + c * words(), A);
+    }
+
+    bool startOnRight = false;
+    for (uint32_t rule = 0; rule < image.ruleCount(); ++rule) {
+        auto body = image.body(rule);
+        for (uint32_t sym : body) {
+            if (static_cast<int>(sym) == startId) startOnRight = true;
+        }
+        if (body.empty()) {
+            if (static_cast<int>(image.head(rule)) == startId) startEmpty = true;
+            else cnf = false;
+        } else if (body.size() == 1) {
+            if (body[0] < nV) cnf = false;
+        } else if (body.size() == 2) {
+            if (body[0] >= nV || body[1] >= nV) cnf = false;
+        } else {
+            cnf = false;
+        }
+    }
+    if (startEmpty && startOnRight) cnf = false;
+
+    analyseStart();
+    analyseLengths();
+}
+
+namespace {
+    // a + b, maar hoogstens limit; diepe ketens A_i -> A_{i-1} A_{i-1} verdubbelen de lengte per stap
+    size_t saturatedSum(size_t a, size_t b, size_t limit) {
+        return a > limit || b > limit - a ? limit : a + b;
+    }
+}
+
+// FIRST/LAST-bytes en de mogelijke lengtes van S, over de regels die CYK gebruikt (A -> c en A -> B C)
+void CompiledGrammar::analyseStart() {
+    const uint32_t nV = image.variableCount();
+    const size_t none = SIZE_MAX;
+
+    for (int c = 0; c < 256; ++c) {
+        if (anyBit(byteVariables(c), words())) alphabet[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    // kortste afleiding per variabele; none = afleidt niets (niet productief)
+    vector<size_t> minLen(nV, none);
+    vector<array<uint64_t, 4>> first(nV), last(nV);
+    for (int c = 0; c < 256; ++c) {
+        forEachBit(byteVariables(c), words(), [&](uint32_t A) {
+            minLen[A] = 1;
+            first[A][c >> 6] |= uint64_t(1) << (c & 63);
+            last[A][c >> 6] |= uint64_t(1) << (c & 63);
+        });
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (uint32_t B = 0; B < nV; ++B) {
+            if (minLen[B] == none) continue;
+            auto rules = image.binaryRules(B);
+            for (size_t r = 0; r < rules.size(); r += 2) {
+                uint32_t C = rules[r], A = rules[r + 1];
+                if (minLen[C] == none) continue;
+                // none - 1 als bovengrens, none betekent "niet productief"
+                const size_t length = saturatedSum(minLen[B], minLen[C], none - 1);
+                if (length < minLen[A]) {
+                    minLen[A] = length;
+                    changed = true;
+                }
+                for (int w = 0; w < 4; ++w) {
+                    if ((first[A][w] | first[B][w]) != first[A][w] || (last[A][w] | last[C][w]) != last[A][w]) {
+                        first[A][w] |= first[B][w];
+                        last[A][w] |= last[C][w];
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    if (startId < 0 || minLen[startId] == none) {
+        // S leidt niets niet-leegs af
+        shortest = 0;
+        longest = 0;
+        return;
+    }
+    shortest = minLen[startId];
+    firstBytes = first[startId];
+    lastBytes = last[startId];
+
+    // langste afleiding: oneindig als er vanuit S een cyclus over productieve regels bereikbaar is,
+    // anders van onder naar boven in topologische volgorde
+    vector<vector<uint32_t>> parents(nV);
+    vector<size_t> pending(nV, 0);
+    vector<char> reached(nV, 0);
+    vector<uint32_t> todo{static_cast<uint32_t>(startId)};
+    reached[startId] = 1;
+    while (!todo.empty()) {
+        uint32_t A = todo.back();
+        todo.pop_back();
+        for (uint32_t rule = image.firstRule(A); rule < image.endRule(A); ++rule) {
+            auto body = image.body(rule);
+            if (body.size() != 2 || body[0] >= nV || body[1] >= nV) continue;
+            if (minLen[body[0]] == none || minLen[body[1]] == none) continue;
+            for (uint32_t child : body) {
+                parents[child].push_back(A);
+                ++pending[A];
+                if (!reached[child]) {
+                    reached[child] = 1;
+                    todo.push_back(child);
+                }
+            }
+        }
+    }
+
+    vector<size_t> maxLen(nV, 0);
+    size_t reachable = 0, done = 0;
+    for (uint32_t A = 0; A < nV; ++A) {
+        if (!reached[A]) continue;
+        ++reachable;
+        if (minLen[A] == 1) maxLen[A] = 1;
+        if (pending[A] == 0) todo.push_back(A);
+    }
+    while (!todo.empty()) {
+        uint32_t A = todo.back();
+        todo.pop_back();
+        ++done;
+        for (uint32_t rule = image.firstRule(A); rule < image.endRule(A); ++rule) {
+            auto body = image.body(rule);
+            if (body.size() != 2 || body[0] >= nV || body[1] >= nV) continue;
+            if (minLen[body[0]] == none || minLen[body[1]] == none) continue;
+            // verzadigd op none, dat ook "onbegrensd" betekent
+            maxLen[A] = max(maxLen[A], saturatedSum(maxLen[body[0]], maxLen[body[1]], none));
+        }
+        for (uint32_t parent : parents[A]) {
+            if (--pending[parent] == 0) todo.push_back(parent);
+        }
+    }
+    longest = done < reachable ? none : maxLen[startId];
+}
+
+bool CompiledGrammar::mayHaveLength(size_t n) const {
+    if (startId < 0) return false;
+    if (n == 0) return startEmpty;
+    if (n < shortest || n > longest) return false;
+    return lengthSets[startId].contains(n);
+}
+
+bool CompiledGrammar::mayAccept(string_view input) const {
+    if (!mayHaveLength(input.size())) return false;
+    if (input.empty()) return true;
+
+    auto has = [](const array<uint64_t, 4> &set, unsigned char c) {
+        return (set[c >> 6] >> (c & 63)) & 1;
+    };
+    if (!has(firstBytes, input.front()) || !has(lastBytes, input.back())) return false;
+    for (char c : input) {
+        if (!has(alphabet, static_cast<unsigned char>(c))) return false;
+    }
+    return true;
+}
+
+namespace {
+    // grootste hoeveelheid werk (ongeveer het aantal stappen) die de lengte-analyse mag doen
+    const size_t LengthBudget = size_t(1) << 27;
+    const size_t MaxHorizon = 1024;
+    const size_t MaxPeriod = 1024;
+    // grootte van de gefilterde regellijsten, anders enkel de gewone binaryRules
+    const size_t MaxLengthRules = size_t(1) << 22;
+}
+
+// Lengtes per variabele. Eerst exact tot een horizon H (dynamisch programmeren over A -> B C), dan per
+// variabele de kleinste periode gokken die het einde van dat stuk verklaart. Die gok X is goed als
+// X_B + X_C ⊆ X_A voor elke A -> B C: dan is X een pre-vast punt en bevat het de kleinste oplossing.
+// Met gemeenschappelijke periode P en drempel T is X_B + X_C periodiek vanaf 2T + P, dus volstaat het
+// om dat tot 2T + 2P na te gaan. Lukt het niet, dan H verdubbelen; op het einde blijft exact tot H
+// en "alles kan" daarna over.
+void CompiledGrammar::analyseLengths() {
+    const uint32_t nV = image.variableCount();
+    size_t pairs = 0;
+    for (uint32_t B = 0; B < nV; ++B) pairs += image.binaryRules(B).size() / 2;
+
+    auto forEachRule = [&](auto &&f) {
+        for (uint32_t B = 0; B < nV; ++B) {
+            auto rules = image.binaryRules(B);
+            for (size_t r = 0; r < rules.size(); r += 2) f(rules[r + 1], B, rules[r]);
+        }
+    };
+
+    // zonder analyse: elke lengte vanaf 1
+    LengthSet any;
+    any.Threshold = 1;
+    any.bits = {0, 1};
+    lengthSets.assign(nV, any);
+    lengthThreshold = 1;
+    lengthPeriod = 1;
+
+    vector<vector<char>> exact;
+    size_t horizon = 0;
+    for (size_t H = 64; H <= MaxHorizon; H *= 2) {
+        if ((pairs + nV) * H * H / 2 > LengthBudget) break;
+        horizon = H;
+
+        exact.assign(nV, vector<char>(H, 0));
+        for (int c = 0; c < 256; ++c) {
+            forEachBit(byteVariables(c), words(), [&](uint32_t A) { exact[A][1] = 1; });
+        }
+        for (size_t length = 2; length < H; ++length) {
+            forEachRule([&](uint32_t A, uint32_t B, uint32_t C) {
+                if (exact[A][length]) return;
+                for (size_t i = 1; i < length; ++i) {
+                    if (exact[B][i] && exact[C][length - i]) {
+                        exact[A][length] = 1;
+                        return;
+                    }
+                }
+            });
+        }
+
+        // per variabele de kleinste periode p met drempel t zodat minstens twee periodes gezien zijn
+        vector<LengthSet> guess(nV);
+        bool found = true;
+        size_t T = 0, P = 1;
+        for (uint32_t A = 0; A < nV && found; ++A) {
+            const vector<char> &bits = exact[A];
+            found = false;
+            for (size_t p = 1; p <= H / 4 && !found; ++p) {
+                size_t t = 0;
+                for (size_t i = H - p; i-- > 0;) {
+                    if (bits[i] != bits[i + p]) {
+                        t = i + 1;
+                        break;
+                    }
+                }
+                if (t > H / 2 || t + 2 * p > H) continue;
+                guess[A].Threshold = t;
+                guess[A].Period = p;
+                guess[A].bits.assign(bits.begin(), bits.begin() + t + p);
+                found = true;
+            }
+            if (!found) break;
+            T = max(T, guess[A].Threshold);
+            P = lcm(P, guess[A].Period);
+            if (P > MaxPeriod) found = false;
+        }
+        if (!found) continue;
+
+        // nagaan dat de gok gesloten is onder A -> B C, tot 2T + 2P
+        const size_t range = 2 * T + 2 * P;
+        if (pairs * range * range / 2 > LengthBudget) continue;
+        vector<vector<char>> member(nV, vector<char>(range));
+        for (uint32_t A = 0; A < nV; ++A) {
+            for (size_t i = 0; i < range; ++i) member[A][i] = guess[A].contains(i);
+        }
+        bool closed = true;
+        forEachRule([&](uint32_t A, uint32_t B, uint32_t C) {
+            for (size_t length = 2; length < range && closed; ++length) {
+                if (member[A][length]) continue;
+                for (size_t i = 1; i < length; ++i) {
+                    if (member[B][i] && member[C][length - i]) {
+                        closed = false;
+                        break;
+                    }
+                }
+            }
+        });
+        if (!closed) continue;
+
+        lengthSets = std::move(guess);
+        lengthThreshold = T;
+        lengthPeriod = P;
+        horizon = 0;
+        break;
+    }
+
+    if (horizon > 0) {
+        // geen vast punt gevonden: exact tot de horizon, daarna alles
+        for (uint32_t A = 0; A < nV; ++A) {
+            lengthSets[A].Threshold = horizon;
+            lengthSets[A].Period = 1;
+            lengthSets[A].bits = std::move(exact[A]);
+            lengthSets[A].bits.push_back(1);
+        }
+        lengthThreshold = horizon;
+        lengthPeriod = 1;
+    }
+
+    // per lengteklasse de regels met een kop die die lengte kan afleiden
+    const size_t classes = lengthThreshold + lengthPeriod;
+    if (classes * pairs > MaxLengthRules) return;
+    lengthRuleStart.assign(classes * nV + 1, 0);
+    lengthRules.clear();
+    for (size_t k = 0; k < classes; ++k) {
+        for (uint32_t B = 0; B < nV; ++B) {
+            auto rules = image.binaryRules(B);
+            for (size_t r = 0; r < rules.size(); r += 2) {
+                if (!lengthSets[rules[r + 1]].contains(k)) continue;
+                lengthRules.push_back(rules[r]);
+                lengthRules.push_back(rules[r + 1]);
+            }
+            lengthRuleStart[k * nV + B + 1] = static_cast<uint32_t>(lengthRules.size());
+        }
+    }
+}
+
+size_t CompiledGrammar::lengthClass(size_t length) const {
+    if (length < lengthThreshold) return length;
+    return lengthThreshold + (length - lengthThreshold) % lengthPeriod;
+}
+
+span<const uint32_t> CompiledGrammar::binaryRules(uint32_t left, size_t length) const {
+    if (lengthRuleStart.empty()) return image.binaryRules(left);
+    size_t at = lengthClass(length) * variableCount() + left;
+    return {lengthRules.data() + lengthRuleStart[at], lengthRules.data() + lengthRuleStart[at + 1]};
+}
+
+bool CompiledGrammar::lengthPossible(size_t length) const {
+    if (lengthRuleStart.empty()) return true;
+    size_t k = lengthClass(length);
+    return lengthRuleStart[(k + 1) * variableCount()] > lengthRuleStart[k * variableCount()];
+}
+
+namespace {
+    // namen zijn per soort alfabetisch, dus binair zoeken in [first, last)
+    int search(const GrammarImage &image, uint32_t first, uint32_t last, string_view name) {
+        while (first < last) {
+            uint32_t mid = first + (last - first) / 2;
+            if (image.name(mid) < name) first = mid + 1;
+            else last = mid;
+        }
+        return first < image.symbolCount() && image.name(first) == name ? static_cast<int>(first) : -1;
+    }
+}
+
+int CompiledGrammar::variableId(string_view name) const {
+    int id = search(image, 0, image.variableCount(), name);
+    return id < static_cast<int>(image.variableCount()) ? id : -1;
+}
+
+int CompiledGrammar::terminalId(string_view name) const {
+    return search(image, image.variableCount(), image.symbolCount(), name);
+}
@@ -0,0 +1,69 @@
+#include "../include/DeterministicRunner.h"
+
+DeterministicRunner::DeterministicRunner(const TransitionIndex &index) : index(index) {
+    size_t pairs = index.States.size() * index.StackSymbols.size();
+    seenRun.assign(pairs, 0);
+    seenLevel.assign(pairs, 0);
+    seenGeneration.assign(pairs, 0);
+}
+
+bool DeterministicRunner::accepts(string_view input) {
+    stack.clear();
+    generation.assign(1, 0);
+    if (index.StartState < 0 || index.StartStack < 0) return false;
+
+    int state = index.StartState;
+    stack.push_back(index.StartStack);
+    generation.push_back(0);
+
+    size_t pos = 0;
+    ++run;
+    while (!stack.empty()) {
+        int top = stack.back();
+        if (!index.epsilonMoves(state, top).empty()) {
+            if (!epsilonStep(state)) return false;
+            continue;
+        }
+
+        if (pos == input.size()) return false;
+        int symbol = index.inputOf(static_cast<unsigned char>(input[pos]));
+        if (symbol < 0) return false;
+        auto moves = index.moves(state, symbol, top);
+        if (moves.empty()) return false;
+
+        const CodedTransition &move = moves[0];
+        stack.pop_back();
+        if (move.replacementLength == 0) ++generation[stack.size() + 1];
+        auto replacement = index.replacement(move);
+        for (size_t i = replacement.size(); i-- > 0;) stack.push_back(replacement[i]);
+        if (generation.size() <= stack.size()) generation.resize(stack.size() + 1, 0);
+        state = move.to;
+        ++pos;
+        ++run;
+    }
+    return pos == input.size();
+}
+
+// Eén epsilon-stap, false als de PDA vanaf hier eindeloos epsilon-stappen blijft doen.
+// Komen we in dezelfde run opnieuw in (state, top) terwijl de stapel nooit onder de hoogte van
+// de vorige keer is gezakt, dan herhaalt de deterministische berekening zich voor altijd.
+// generation[h] telt hoe vaak hoogte h leeggemaakt werd, zo is dat in O(1) te controleren.
+bool DeterministicRunner::epsilonStep(int &state) {
+    int top = stack.back();
+    const size_t height = stack.size();
+    size_t key = static_cast<size_t>(state) * index.StackSymbols.size() + top;
+    if (seenRun[key] == run && seenLevel[key] < generation.size()
+        && seenGeneration[key] == generation[seenLevel[key]]) return false;
+    seenRun[key] = run;
+    seenLevel[key] = height;
+    seenGeneration[key] = generation[height];
+
+    const CodedTransition &move = index.epsilonMoves(state, top)[0];
+    stack.pop_back();
+    if (move.replacementLength == 0) ++generation[height];
+    auto replacement = index.replacement(move);
+    for (size_t i = replacement.size(); i-- > 0;) stack.push_back(replacement[i]);
+    if (generation.size() <= stack.size()) generation.resize(stack.size() + 1, 0);
+    state = move.to;
+    return true;
+}
@@ -0,0 +1,99 @@
+#include "../include/EpsilonClosure.h"
+#include <deque>
+#include <set>
+
+EpsilonClosure::EpsilonClosure(const TransitionIndex &index, size_t bound) : Bound(bound) {
+    const size_t nStates = index.States.size();
+    nStack = index.StackSymbols.size();
+    const size_t nPairs = nStates * nStack;
+
+    // pops als vaste punt: (s, X) -> t met vervanging Y1..Yk, daarna Y1..Yk één voor één wegwerken
+    vector<vector<char>> pop(nPairs, vector<char>(nStates, 0));
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t s = 0; s < nStates; ++s) {
+            for (size_t X = 0; X < nStack; ++X) {
+                vector<char> &target = pop[s * nStack + X];
+                for (const CodedTransition &move : index.epsilonMoves(s, X)) {
+                    vector<char> current(nStates, 0);
+                    current[move.to] = 1;
+                    for (int Y : index.replacement(move)) {
+                        vector<char> next(nStates, 0);
+                        for (size_t c = 0; c < nStates; ++c) {
+                            if (!current[c]) continue;
+                            const vector<char> &after = pop[c * nStack + Y];
+                            for (size_t p = 0; p < nStates; ++p) next[p] |= after[p];
+                        }
+                        current.swap(next);
+                    }
+                    for (size_t p = 0; p < nStates; ++p) {
+                        if (current[p] && !target[p]) {
+                            target[p] = 1;
+                            changed = true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    popStart.assign(nPairs + 1, 0);
+    erasableSymbols.assign(nStack, 0);
+    for (size_t key = 0; key < nPairs; ++key) {
+        for (size_t p = 0; p < nStates; ++p) {
+            if (pop[key][p]) popStates.push_back(static_cast<int>(p));
+        }
+        popStart[key + 1] = static_cast<int>(popStates.size());
+        if (popStart[key + 1] > popStart[key]) erasableSymbols[key % nStack] = 1;
+    }
+
+    // reach en frontier: breedte-eerst over (state, γ) met |γ| <= Bound, pops gebruikt als snelkoppeling
+    reachStart.assign(nPairs + 1, 0);
+    frontierStart.assign(nPairs + 1, 0);
+    for (size_t q = 0; q < nStates; ++q) {
+        for (size_t X = 0; X < nStack; ++X) {
+            const int state = static_cast<int>(q), top = static_cast<int>(X);
+            set<pair<int, vector<int>>> seen{{state, {top}}};
+            set<pair<int, vector<int>>> outside;
+            deque<pair<int, vector<int>>> todo{{state, {top}}};
+
+            while (!todo.empty()) {
+                auto [s, gamma] = todo.front();
+                todo.pop_front();
+                int Y = gamma[0];
+
+                for (const CodedTransition &move : index.epsilonMoves(s, Y)) {
+                    auto replacement = index.replacement(move);
+                    vector<int> next(replacement.begin(), replacement.end());
+                    next.insert(next.end(), gamma.begin() + 1, gamma.end());
+                    if (next.empty()) continue;
+                    if (next.size() > Bound) {
+                        outside.emplace(move.to, std::move(next));
+                    } else if (seen.emplace(move.to, next).second) {
+                        todo.emplace_back(move.to, std::move(next));
+                    }
+                }
+
+                if (gamma.size() > 1) {
+                    vector<int> rest(gamma.begin() + 1, gamma.end());
+                    for (int t : pops(s, Y)) {
+                        if (seen.emplace(t, rest).second) todo.emplace_back(t, rest);
+                    }
+                }
+            }
+
+            seen.erase({state, {top}});
+            for (const auto &[p, gamma] : seen) {
+                reachEntries.push_back({p, static_cast<int>(words.size()), static_cast<int>(gamma.size())});
+                words.insert(words.end(), gamma.begin(), gamma.end());
+            }
+            for (const auto &[p, gamma] : outside) {
+                frontierEntries.push_back({p, static_cast<int>(words.size()), static_cast<int>(gamma.size())});
+                words.insert(words.end(), gamma.begin(), gamma.end());
+            }
+            reachStart[q * nStack + X + 1] = static_cast<int>(reachEntries.size());
+            frontierStart[q * nStack + X + 1] = static_cast<int>(frontierEntries.size());
+        }
+    }
+}
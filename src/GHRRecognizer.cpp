@@ -0,0 +1,37 @@
+#include "../include/GHRRecognizer.h"
+#include "../include/Bits.h"
+
+GHRRecognizer::GHRRecognizer(const CompiledGrammar &grammar) : grammar(grammar) {}
+
+bool GHRRecognizer::accepts(string_view input) {
+    const size_t n = input.size();
+    const size_t nV = grammar.variableCount();
+    words = (n + 1 + 63) / 64;
+    bits.assign(n * nV * words, 0);
+    if (grammar.start() < 0) return false;
+    if (Prefilter && !grammar.mayAccept(input)) return false;
+    if (n == 0) return grammar.derivesEmpty();
+
+    for (size_t i = n; i-- > 0;) {
+        // lengte 1: A -> input[i] eindigt op i + 1
+        const uint64_t *unit = grammar.byteVariables(static_cast<unsigned char>(input[i]));
+        forEachBit(unit, grammar.words(), [&](uint32_t A) { setBit(ends(A, i), static_cast<uint32_t>(i + 1)); });
+
+        // bits tot en met k liggen vast zodra alle splitsingen voor k behandeld zijn,
+        // want een split op k zet enkel eindes > k
+        for (size_t k = i + 1; k < n; ++k) {
+            const size_t firstWord = (k + 1) >> 6;
+            for (uint32_t B = 0; B < nV; ++B) {
+                if (!testBit(ends(B, i), static_cast<uint32_t>(k))) continue;
+                auto rules = grammar.binaryRules(B);
+                for (size_t r = 0; r < rules.size(); r += 2) {
+                    const uint64_t *right = ends(rules[r], k);
+                    uint64_t *target = ends(rules[r + 1], i);
+                    for (size_t w = firstWord; w < words; ++w) target[w] |= right[w];
+                }
+            }
+        }
+    }
+
+    return testBit(ends(grammar.start(), 0), static_cast<uint32_t>(n));
+}
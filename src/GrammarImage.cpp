@@ -0,0 +1,281 @@
+#include "../include/GrammarImage.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr size_t HeaderWords = 16;
+
+    // CSR-offsets: count + 1 stijgende waarden van 0 tot precies end
+    bool offsetsValid(const uint32_t *start, uint64_t count, uint64_t end) {
+        if (start[0] != 0 || start[count] != end) return false;
+        for (uint64_t i = 0; i < count; ++i) {
+            if (start[i] > start[i + 1]) return false;
+        }
+        return true;
+    }
+
+    bool idsBelow(const uint32_t *ids, uint64_t count, uint64_t limit) {
+        for (uint64_t i = 0; i < count; ++i) {
+            if (ids[i] >= limit) return false;
+        }
+        return true;
+    }
+}
+
+GrammarImage::GrammarImage(GrammarImage &&other) noexcept {
+    *this = std::move(other);
+}
+
+GrammarImage &GrammarImage::operator=(GrammarImage &&other) noexcept {
+    if (this == &other) return *this;
+    release();
+    owned = std::move(other.owned);
+    mapping = other.mapping;
+    mappingSize = other.mappingSize;
+    other.mapping = nullptr;
+    other.mappingSize = 0;
+
+    // de pointers wijzen in owned of in de mapping, die beide meeverhuizen
+    words = other.words;
+    nameStart = other.nameStart;
+    ruleHead = other.ruleHead;
+    headStart = other.headStart;
+    bodyStart = other.bodyStart;
+    bodies = other.bodies;
+    unitStart = other.unitStart;
+    unitHead = other.unitHead;
+    binaryStart = other.binaryStart;
+    binaryPairs = other.binaryPairs;
+    names = other.names;
+    other.words = nullptr;
+    return *this;
+}
+
+GrammarImage::~GrammarImage() {
+    release();
+}
+
+void GrammarImage::release() {
+#ifndef _WIN32
+    if (mapping) munmap(mapping, mappingSize);
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    owned.clear();
+    words = nullptr;
+}
+
+// secties opzoeken in een blok en nagaan dat alles erin past
+bool GrammarImage::attach(const uint32_t *data, size_t count) {
+    if (count < HeaderWords || data[0] != Magic || data[1] != Version) return false;
+    const uint64_t nV = data[2], nT = data[3], nRules = data[5], nBody = data[6];
+    const uint64_t nameBytes = data[7], nUnit = data[8], nBinary = data[9];
+
+    const uint64_t total = HeaderWords + (nV + nT + 1) + nRules + (nV + 1) + (nRules + 1) + nBody
+                           + (nT + 1) + nUnit + (nV + 1) + 2 * nBinary + (nameBytes + 3) / 4;
+    if (total > count) return false;
+
+    const uint32_t *at = data + HeaderWords;
+    nameStart = at; at += nV + nT + 1;
+    ruleHead = at; at += nRules;
+    headStart = at; at += nV + 1;
+    bodyStart = at; at += nRules + 1;
+    bodies = at; at += nBody;
+    unitStart = at; at += nT + 1;
+    unitHead = at; at += nUnit;
+    binaryStart = at; at += nV + 1;
+    binaryPairs = at; at += 2 * nBinary;
+    names = reinterpret_cast<const char *>(at);
+
+    // een afgekapt of verouderd bestand mag nooit leiden tot lezen buiten het blok: één lineaire controle
+    // van alle offsets en symboolnummers, zonder iets te kopiëren
+    if (data[4] != None && data[4] >= nV) return false;
+    if (!offsetsValid(nameStart, nV + nT, nameBytes) || !offsetsValid(headStart, nV, nRules)
+        || !offsetsValid(bodyStart, nRules, nBody) || !offsetsValid(unitStart, nT, nUnit)
+        || !offsetsValid(binaryStart, nV, nBinary)) return false;
+    if (!idsBelow(ruleHead, nRules, nV) || !idsBelow(bodies, nBody, nV + nT)
+        || !idsBelow(unitHead, nUnit, nV) || !idsBelow(binaryPairs, 2 * nBinary, nV)) return false;
+
+    words = data;
+    return true;
+}
+
+GrammarImage GrammarImage::fromCFG(const CFG &cfg) {
+    vector<pair<string, vector<string>>> productions;
+    cfg.forEachProduction([&](const string &head, const vector<string> &body) {
+        productions.emplace_back(head, body);
+    });
+
+    // alles wat als variabele gedeclareerd is of links in een productie staat is een variabele,
+    // de rest van de symbolen zijn terminals
+    set<string> variables, terminals;
+    for (const auto &var : cfg.V) variables.insert(symbolName(var));
+    for (const auto &[head, body] : productions) variables.insert(head);
+    for (const auto &t : cfg.T) {
+        if (!variables.count(t)) terminals.insert(t);
+    }
+    for (const auto &[head, body] : productions) {
+        for (const auto &sym : body) {
+            if (!variables.count(sym)) terminals.insert(sym);
+        }
+    }
+
+    map<string, uint32_t> ids;
+    vector<const string *> symbols;
+    for (const auto &name : variables) {
+        ids.emplace(name, static_cast<uint32_t>(symbols.size()));
+        symbols.push_back(&name);
+    }
+    for (const auto &name : terminals) {
+        ids.emplace(name, static_cast<uint32_t>(symbols.size()));
+        symbols.push_back(&name);
+    }
+    const uint32_t nV = variables.size(), nT = terminals.size();
+
+    // regels stabiel sorteren op head
+    vector<uint32_t> order(productions.size());
+    for (uint32_t r = 0; r < order.size(); ++r) order[r] = r;
+    stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return ids[productions[a].first] < ids[productions[b].first];
+    });
+
+    vector<uint32_t> nameStart{0}, ruleHead, headStart(nV + 1, 0), bodyStart{0}, bodies;
+    string names;
+    for (const string *name : symbols) {
+        names += *name;
+        nameStart.push_back(static_cast<uint32_t>(names.size()));
+    }
+
+    vector<vector<uint32_t>> unit(nT), binary(nV);
+    for (uint32_t r : order) {
+        const auto &[head, body] = productions[r];
+        uint32_t A = ids[head];
+        uint32_t rule = static_cast<uint32_t>(ruleHead.size());
+        ruleHead.push_back(A);
+        ++headStart[A + 1];
+        for (const auto &sym : body) bodies.push_back(ids[sym]);
+        bodyStart.push_back(static_cast<uint32_t>(bodies.size()));
+
+        span<const uint32_t> rhs(bodies.data() + bodyStart[rule], bodies.data() + bodyStart[rule + 1]);
+        if (rhs.size() == 1 && rhs[0] >= nV) {
+            unit[rhs[0] - nV].push_back(A);
+        } else if (rhs.size() == 2 && rhs[0] < nV && rhs[1] < nV) {
+            binary[rhs[0]].push_back(rhs[1]);
+            binary[rhs[0]].push_back(A);
+        }
+    }
+    for (uint32_t A = 0; A < nV; ++A) headStart[A + 1] += headStart[A];
+
+    // een regel die twee keer in de grammatica staat telt voor CYK (en voor het tellen van afleidingen)
+    // maar één keer; de volgorde binnen een lijst maakt niets uit
+    for (auto &heads : unit) {
+        sort(heads.begin(), heads.end());
+        heads.erase(unique(heads.begin(), heads.end()), heads.end());
+    }
+    for (auto &pairs : binary) {
+        vector<uint64_t> packed;
+        for (size_t i = 0; i < pairs.size(); i += 2) packed.push_back(uint64_t(pairs[i]) << 32 | pairs[i + 1]);
+        sort(packed.begin(), packed.end());
+        packed.erase(unique(packed.begin(), packed.end()), packed.end());
+        pairs.clear();
+        for (uint64_t pair : packed) {
+            pairs.push_back(static_cast<uint32_t>(pair >> 32));
+            pairs.push_back(static_cast<uint32_t>(pair));
+        }
+    }
+
+    vector<uint32_t> unitStart{0}, unitHead, binaryStart{0}, binaryPairs;
+    for (const auto &heads : unit) {
+        unitHead.insert(unitHead.end(), heads.begin(), heads.end());
+        unitStart.push_back(static_cast<uint32_t>(unitHead.size()));
+    }
+    for (const auto &pairs : binary) {
+        binaryPairs.insert(binaryPairs.end(), pairs.begin(), pairs.end());
+        binaryStart.push_back(static_cast<uint32_t>(binaryPairs.size() / 2));
+    }
+
+    auto start = ids.find(cfg.S);
+    vector<uint32_t> header(HeaderWords, 0);
+    header[0] = Magic;
+    header[1] = Version;
+    header[2] = nV;
+    header[3] = nT;
+    header[4] = start != ids.end() && start->second < nV ? start->second : None;
+    header[5] = static_cast<uint32_t>(ruleHead.size());
+    header[6] = static_cast<uint32_t>(bodies.size());
+    header[7] = static_cast<uint32_t>(names.size());
+    header[8] = static_cast<uint32_t>(unitHead.size());
+    header[9] = static_cast<uint32_t>(binaryPairs.size() / 2);
+
+    GrammarImage image;
+    vector<uint32_t> &out = image.owned;
+    for (const auto *section : {&header, &nameStart, &ruleHead, &headStart, &bodyStart, &bodies,
+                                &unitStart, &unitHead, &binaryStart, &binaryPairs}) {
+        out.insert(out.end(), section->begin(), section->end());
+    }
+    size_t at = out.size();
+    out.resize(at + (names.size() + 3) / 4, 0);
+    memcpy(out.data() + at, names.data(), names.size());
+
+    image.attach(out.data(), out.size());
+    return image;
+}
+
+GrammarImage GrammarImage::load(const string &filename) {
+    GrammarImage image;
+#ifdef _WIN32
+    ifstream input(filename, ios::binary);
+    if (!input.is_open()) {
+        cerr << "Fout: kon bestand '" << filename << "' niet openen." << endl;
+        return image;
+    }
+    vector<char> bytes((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+    image.owned.resize(bytes.size() / 4);
+    memcpy(image.owned.data(), bytes.data(), image.owned.size() * 4);
+    if (!image.attach(image.owned.data(), image.owned.size())) {
+        cerr << "Fout: '" << filename << "' is geen gecompileerde grammatica." << endl;
+        image.release();
+    }
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "Fout: kon bestand '" << filename << "' niet openen." << endl;
+        return image;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void *data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            image.mapping = data;
+            image.mappingSize = info.st_size;
+        }
+    }
+    close(fd);
+    if (!image.mapping || !image.attach(static_cast<const uint32_t *>(image.mapping), image.mappingSize / 4)) {
+        cerr << "Fout: '" << filename << "' is geen gecompileerde grammatica." << endl;
+        image.release();
+    }
+#endif
+    return image;
+}
+
+void GrammarImage::save(const string &filename) const {
+    ofstream output(filename, ios::binary);
+    if (!output.is_open() || !valid()) {
+        cerr << "Fout: kon bestand '" << filename << "' niet schrijven." << endl;
+        return;
+    }
+    size_t count = reinterpret_cast<const uint32_t *>(names) - words + (words[7] + 3) / 4;
+    output.write(reinterpret_cast<const char *>(words), static_cast<streamsize>(count * sizeof(uint32_t)));
+}
@@ -0,0 +1,74 @@
+#include "../include/GrammarRegistry.h"
+#include <iostream>
+
+GrammarRegistry::~GrammarRegistry() {
+    wait();
+    delete published.load();
+}
+
+// aanmelden in de huidige epoch, de pointer lezen en kopiëren, afmelden; opnieuw als de epoch intussen wisselde
+GrammarRegistry::Snapshot GrammarRegistry::current() const {
+    while (true) {
+        const uint64_t e = epoch.load();
+        atomic<uint64_t> &slot = readers[e & 1];
+        slot.fetch_add(1);
+        if (epoch.load() != e) {
+            slot.fetch_sub(1);
+            continue;
+        }
+        const Snapshot *holder = published.load();
+        Snapshot snapshot = holder ? *holder : nullptr;
+        slot.fetch_sub(1);
+        return snapshot;
+    }
+}
+
+bool GrammarRegistry::reloadNow(const string &filename) {
+    // het nummer ligt vast bij het begin, zodat een tragere oudere reload een nieuwere niet overschrijft
+    uint64_t number = ++versions;
+    CFG cfg(filename);
+    if (cfg.P.empty()) {
+        cerr << "Fout: '" << filename << "' bevat geen grammatica, versie " << number << " niet gepubliceerd." << endl;
+        return false;
+    }
+    publish(make_shared<const Version>(number, filename, cfg));
+    return true;
+}
+
+void GrammarRegistry::reload(const string &filename) {
+    lock_guard<mutex> guard(workersLock);
+    // afgelopen threads nu al joinen, anders groeit workers in een proces dat regelmatig herlaadt
+    erase_if(workers, [](Worker &running) {
+        if (!running.done->load()) return false;
+        running.worker.join();
+        return true;
+    });
+
+    auto done = make_shared<atomic<bool>>(false);
+    workers.push_back({thread([this, filename, done] {
+        reloadNow(filename);
+        done->store(true);
+    }), done});
+}
+
+void GrammarRegistry::wait() {
+    vector<Worker> running;
+    {
+        lock_guard<mutex> guard(workersLock);
+        running.swap(workers);
+    }
+    for (auto &worker : running) worker.worker.join();
+}
+
+// enkel schrijvers nemen de lock; na het wisselen van de pointer de epoch verhogen en wachten tot de lezers
+// die nog in de vorige epoch zaten klaar zijn, pas dan kan niemand de oude houder nog aan het kopiëren zijn
+void GrammarRegistry::publish(Snapshot next) {
+    lock_guard<mutex> guard(publishing);
+    const Snapshot *old = published.load();
+    if (old && (*old)->number > next->number) return;
+
+    old = published.exchange(new Snapshot(std::move(next)));
+    const uint64_t e = epoch.fetch_add(1);
+    while (readers[e & 1].load() != 0) this_thread::yield();
+    delete old;
+}
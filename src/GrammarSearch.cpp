@@ -0,0 +1,65 @@
+#include "../include/GrammarSearch.h"
+#include "../include/Bits.h"
+#include <algorithm>
+#include <iostream>
+
+GrammarSearch::GrammarSearch(const CompiledGrammar &grammar, size_t limit, int target)
+    : grammar(grammar), maxSpan(max<size_t>(1, limit)), target(target < 0 ? grammar.start() : target) {
+    if (this->target >= 0 && static_cast<size_t>(this->target) >= grammar.variableCount()) {
+        cerr << "Fout: variabele " << this->target << " bestaat niet (de grammatica heeft er "
+             << grammar.variableCount() << "), er wordt niets gevonden." << endl;
+        this->target = -1;
+    }
+    reset();
+}
+
+void GrammarSearch::reset() {
+    consumed = 0;
+    ring.assign(maxSpan * maxSpan * grammar.words(), 0);
+}
+
+void GrammarSearch::feed(string_view text, const Match &match) {
+    for (char c : text) step(static_cast<unsigned char>(c), match);
+}
+
+void GrammarSearch::search(istream &in, const Match &match) {
+    vector<char> buffer(1 << 16);
+    while (in.read(buffer.data(), buffer.size()) || in.gcount() > 0) {
+        feed(string_view(buffer.data(), static_cast<size_t>(in.gcount())), match);
+    }
+}
+
+// kolom voor het stuk dat eindigt na teken c: eerst lengte 1, dan langer met splits
+// waarvan het linkerdeel in een vorige kolom zit en het rechterdeel eerder in deze kolom
+void GrammarSearch::step(unsigned char c, const Match &match) {
+    const size_t words = grammar.words();
+    const size_t end = consumed++;
+    const size_t longest = min(maxSpan, consumed);
+
+    uint64_t *base = cell(end, 1);
+    const uint64_t *vars = grammar.byteVariables(c);
+    copy(vars, vars + words, base);
+    for (size_t length = 2; length <= maxSpan; ++length) fill(cell(end, length), cell(end, length) + words, 0);
+
+    for (size_t length = 2; length <= longest; ++length) {
+        if (!grammar.lengthPossible(length)) continue;
+        uint64_t *into = cell(end, length);
+        for (size_t split = 1; split < length; ++split) {
+            const uint64_t *left = cell(end - (length - split), split);
+            const uint64_t *right = cell(end, length - split);
+            if (!anyBit(left, words) || !anyBit(right, words)) continue;
+
+            forEachBit(left, words, [&](uint32_t B) {
+                auto rules = grammar.binaryRules(B, length);
+                for (size_t r = 0; r < rules.size(); r += 2) {
+                    if (testBit(right, rules[r])) setBit(into, rules[r + 1]);
+                }
+            });
+        }
+    }
+
+    if (target < 0) return;
+    for (size_t length = 1; length <= longest; ++length) {
+        if (testBit(cell(end, length), static_cast<uint32_t>(target))) match(consumed - length, consumed);
+    }
+}
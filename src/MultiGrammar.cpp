@@ -0,0 +1,106 @@
+#include "../include/MultiGrammar.h"
+#include "../include/Bits.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+
+namespace {
+    // voorvoegsel met vaste breedte, zodat de variabelen van één grammatica na elkaar blijven
+    string prefix(size_t g) {
+        char buffer[24];
+        snprintf(buffer, sizeof(buffer), "%06zu:", g);
+        return buffer;
+    }
+
+    // alle grammatica's in één CFG met disjuncte variabelen; terminals worden gedeeld
+    CFG mergeGrammars(const vector<const CompiledGrammar *> &grammars) {
+        CFG cfg;
+        for (size_t g = 0; g < grammars.size(); ++g) {
+            const GrammarImage &image = grammars[g]->rules();
+            const string tag = prefix(g);
+            const uint32_t nV = image.variableCount();
+
+            for (uint32_t A = 0; A < nV; ++A) cfg.V.push_back({tag + string(image.name(A))});
+            vector<uint32_t> body;
+            for (uint32_t rule = 0; rule < image.ruleCount(); ++rule) {
+                body.clear();
+                for (uint32_t sym : image.body(rule)) {
+                    body.push_back(cfg.P.symbol(sym < nV ? tag + string(image.name(sym)) : string(image.name(sym))));
+                }
+                cfg.P.add(cfg.P.symbol(tag + string(image.name(image.head(rule)))), body, true);
+            }
+            for (uint32_t t = nV; t < image.symbolCount(); ++t) cfg.T.push_back(string(image.name(t)));
+            if (cfg.S.empty() && grammars[g]->start() >= 0) cfg.S = tag + string(image.name(grammars[g]->start()));
+        }
+        cfg.P.compact();
+        return cfg;
+    }
+}
+
+MultiGrammar::MultiGrammar(const vector<const CompiledGrammar *> &grammars)
+    : sources(grammars), combined(mergeGrammars(grammars)), parser(combined) {
+    // het startsymbool van combined is dat van de eerste grammatica, dus geen gezamenlijke voorfilter
+    parser.Prefilter = false;
+    for (size_t g = 0; g < sources.size(); ++g) {
+        int start = sources[g]->start();
+        starts.push_back(start < 0 ? -1 : combined.variableId(prefix(g) + string(sources[g]->name(start))));
+    }
+    buildPrefilter();
+}
+
+void MultiGrammar::buildPrefilter() {
+    grammarWords = (sources.size() + 63) / 64;
+    byteMask.assign(256 * grammarWords, 0);
+    firstMask.assign(256 * grammarWords, 0);
+    lastMask.assign(256 * grammarWords, 0);
+    withStart.assign(grammarWords, 0);
+    candidates.assign(grammarWords, 0);
+
+    auto has = [](const array<uint64_t, 4> &set, unsigned c) { return (set[c >> 6] >> (c & 63)) & 1; };
+    for (size_t g = 0; g < sources.size(); ++g) {
+        if (starts[g] < 0) continue;
+        const uint32_t bit = static_cast<uint32_t>(g);
+        setBit(withStart.data(), bit);
+        for (unsigned c = 0; c < 256; ++c) {
+            if (has(sources[g]->alphabetBytes(), c)) setBit(byteMask.data() + c * grammarWords, bit);
+            if (has(sources[g]->firstByteSet(), c)) setBit(firstMask.data() + c * grammarWords, bit);
+            if (has(sources[g]->lastByteSet(), c)) setBit(lastMask.data() + c * grammarWords, bit);
+        }
+    }
+}
+
+vector<size_t> MultiGrammar::accepts(string_view input) {
+    vector<size_t> result;
+
+    // samengevoegde voorfilter: eerste en laatste byte, dan elke verschillende byte één keer
+    copy(withStart.begin(), withStart.end(), candidates.begin());
+    if (!input.empty()) {
+        auto intersect = [&](const vector<uint64_t> &mask, unsigned char c) {
+            const uint64_t *row = mask.data() + c * grammarWords;
+            for (size_t w = 0; w < grammarWords; ++w) candidates[w] &= row[w];
+        };
+        intersect(firstMask, static_cast<unsigned char>(input.front()));
+        intersect(lastMask, static_cast<unsigned char>(input.back()));
+        array<uint64_t, 4> seen{};
+        for (char ch : input) {
+            const unsigned char c = static_cast<unsigned char>(ch);
+            if ((seen[c >> 6] >> (c & 63)) & 1) continue;
+            seen[c >> 6] |= uint64_t(1) << (c & 63);
+            intersect(byteMask, c);
+        }
+    }
+
+    // de lengtetest is O(1) per kandidaat die overblijft
+    vector<size_t> survivors;
+    forEachBit(candidates.data(), grammarWords, [&](uint32_t g) {
+        if (sources[g]->mayHaveLength(input.size())) survivors.push_back(g);
+    });
+    if (survivors.empty() || input.empty()) return survivors;
+
+    parser.accepts(input);
+    const uint64_t *top = parser.table().cell(input.size(), 0);
+    for (size_t g : survivors) {
+        if (testBit(top, static_cast<uint32_t>(starts[g]))) result.push_back(g);
+    }
+    return result;
+}
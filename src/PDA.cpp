@@ -1,12 +1,58 @@
 #include "../include/PDA.h"
-#include "../json.hpp"
+#include "../include/CFGWriter.h"
+#include "../include/DeterministicRunner.h"
+#include "../include/PDASimulator.h"
+#include "../include/JSONSax.h"
 #include <fstream>
 #include <algorithm>
 #include <sstream>
 #include <iostream>
+#include <memory>
+#include <thread>
 
 using json = nlohmann::json;
 
+namespace {
+    // Vult de PDA terwijl het bestand gelezen wordt; elke transitie gaat meteen in Transitions.
+    class PDASax : public JSONSax {
+    public:
+        explicit PDASax(PDA &pda) : pda(pda) {}
+
+    private:
+        PDA &pda;
+        Transition _transition;
+
+        void value(std::string &val) override {
+            if (depth == 1) {
+                if (section == "StartState") pda.StartState = std::move(val);
+                else if (section == "StartStack") pda.StartStack = std::move(val);
+            } else if (depth == 2) {
+                if (section == "States") pda.States.push_back(std::move(val));
+                else if (section == "Alphabet") pda.Alphabet.push_back(std::move(val));
+                else if (section == "StackAlphabet") pda.StackAlphabet.push_back(std::move(val));
+            } else if (depth == 3 && section == "Transitions") {
+                if (field == "from") _transition.from = std::move(val);
+                else if (field == "input") _transition.input = std::move(val);
+                else if (field == "stacktop") _transition.stacktop = std::move(val);
+                else if (field == "to") _transition.to = std::move(val);
+            } else if (depth == 4 && section == "Transitions" && field == "replacement") {
+                _transition.replacement.push_back(std::move(val));
+            }
+        }
+
+        void opened() override {
+            if (depth == 3 && section == "Transitions") {
+                _transition = Transition();
+                field.clear();
+            }
+        }
+
+        void closed() override {
+            if (depth == 3 && section == "Transitions") pda.Transitions.push_back(std::move(_transition));
+        }
+    };
+}
+
 PDA::PDA(const string &filename) {
     // JSON-bestand openen
     ifstream input(filename);
@@ -15,57 +61,54 @@ PDA::PDA(const string &filename) {
         return;
     }
 
-    json j;
-    input >> j;
-
-    //States inlezen
-    if (j.contains("States") && j["States"].is_array()) {
-        for (const auto &state : j["States"]) States.push_back(state.get<string>());
+    // States, alfabetten, transities en startwaarden inlezen terwijl de tokens binnenkomen
+    PDASax reader(*this);
+    if (!json::sax_parse(input, &reader)) {
+        cerr << "Fout: '" << filename << "' is geen geldige JSON: " << reader.error << endl;
+        States.clear();
+        Alphabet.clear();
+        StackAlphabet.clear();
+        Transitions.clear();
+        StartState.clear();
+        StartStack.clear();
     }
 
-    //Alphabet inlezen
-    if (j.contains("Alphabet") && j["Alphabet"].is_array()) {
-        for (const auto &alphabet : j["Alphabet"]) Alphabet.push_back(alphabet.get<string>());
-    }
-
-    // StackAlphabet inlezen
-    if (j.contains("StackAlphabet") && j["StackAlphabet"].is_array()) {
-        for (const auto &stackAlphabet : j["StackAlphabet"]) StackAlphabet.push_back(stackAlphabet.get<string>());
-    }
+    reindex();
+}
 
-    //transities inlezen
-    if (j.contains("Transitions") && j["Transitions"].is_array()) {
-        for (const auto &trans : j["Transitions"]) {
-            Transition _transition;
-            _transition.from = trans["from"].get<string>();
-            _transition.input =  trans["input"].get<string>();
-            _transition.stacktop = trans["stacktop"].get<string>();
-            _transition.to = trans["to"].get<string>();
+void PDA::reindex() {
+    Index = TransitionIndex(*this);
+    Closure = EpsilonClosure(Index);
+}
 
+bool PDA::isDeterministic() const {
+    return Index.isDeterministic();
+}
 
-            if (trans.contains("replacement") && trans["replacement"].is_array()) {
-                for (const auto &repl : trans["replacement"]) {
-                    _transition.replacement.push_back(repl.get<string>());
-                }
-            }
-            Transitions.push_back(_transition) ;
+bool PDA::accepts(const string &input) const {
+    if (Index.isDeterministic()) {
+        // één runner per thread, hergebruikt zolang het dezelfde index is (ook na een reindex() op hetzelfde adres)
+        thread_local const TransitionIndex *owner = nullptr;
+        thread_local uint64_t serial = 0;
+        thread_local unique_ptr<DeterministicRunner> runner;
+        if (!runner || owner != &Index || serial != Index.serial()) {
+            runner = make_unique<DeterministicRunner>(Index);
+            owner = &Index;
+            serial = Index.serial();
         }
+        return runner->accepts(input);
     }
-
-
-    //StartState inlezen
-    if (j.contains("StartState")) {
-        StartState = j["StartState"].get<string>();
-    }
-
-    //StartStack inlezen
-    if (j.contains("StartStack")) {
-        StartStack = j["StartStack"].get<string>();
-    }
+    PDASimulator simulator(Index, Closure);
+    return simulator.accepts(input);
 }
 
 CFG PDA::toCFG() {
     CFG cfg ;
+    // eerst nagaan dat alle [p,X,q] een 32-bit nummer krijgen, voor er iets van die grootte gemaakt wordt
+    if (!cfg.P.addTriples(Index.States, Index.StackSymbols)) {
+        cerr << "Fout: de PDA heeft te veel variabelen [p,X,q] (|Q|²·|Γ| past niet in 32 bits), geen CFG gemaakt." << endl;
+        return cfg;
+    }
 
     // first we will get teh Varibales of the cfg from the pda
     vector<vector<string>> Variables{{"S"}};
@@ -81,46 +124,161 @@ CFG PDA::toCFG() {
 // //-----------------------------------------------------------------------------------------------------------------------------------------------
     // we get teh Termuinals form teh alphabet
     cfg.T = this->Alphabet;
+//-----------------------------------------------------------------------------------------------------------------------------------------------
+    // de variabelen [p,X,q] in de producties zijn enkel getallen, hun namen worden pas bij het printen gemaakt
+    vector<uint32_t> states;
+    for (const string& State : this->States) states.push_back(Index.stateId(State));
+    vector<uint32_t> inputSymbol;
+    for (const string &input : Index.Inputs) inputSymbol.push_back(cfg.P.symbol(input));
+    inputSymbol.push_back(cfg.P.symbol(string()));
+
 //-----------------------------------------------------------------------------------------------------------------------------------------------      //S transitie met V[0] = S
     // get the S transitie
-    for (const string& State : this->States) {
-        vector<vector<string>> temp {{this->StartState, this->StartStack, State}};
-        cfg.P[cfg.V[0]].push_back(temp);
-
+    const uint32_t start = cfg.P.symbol(cfg.V[0]);
+    for (uint32_t State : states) {
+        uint32_t body = cfg.P.triple(Index.StartState, Index.StartStack, State);
+        cfg.P.add(start, span<const uint32_t>(&body, 1), false);
     }
 
-    // rest van de transities
-    for (int _counter = 0 ; _counter < this->Transitions.size() ; _counter ++) {
-        string from = this->Transitions[_counter].from;
-        string stacktop = this->Transitions[_counter].stacktop;
-        string input  = this->Transitions[_counter].input;
-        string to = this->Transitions[_counter].to;
-        vector<string> replacement = this->Transitions[_counter].replacement;
+    // rest van de transities: per transitie ligt het aantal producties vast, dus elke thread schrijft
+    // rechtstreeks in zijn stuk van één vooraf gealloceerde rij (zelfde volgorde als sequentieel)
+    const vector<CodedTransition> &transitions = Index.transitions();
+    vector<size_t> offset(transitions.size() + 1, 0);
+    for (size_t i = 0; i < transitions.size(); ++i) offset[i + 1] = offset[i] + productionCount(transitions[i]);
+    vector<Production> productions(offset.back());
 
-        if (replacement.size() == 0) {
-            cfg.P[{from, stacktop, to}].push_back({{input}});
-        }
+    size_t threads = 1;
+    if (offset.back() >= ParallelThreshold) {
+        threads = max<size_t>(1, min<size_t>(thread::hardware_concurrency(), transitions.size()));
+    }
 
-        else if (replacement.size() == 1) {
-            for (const string& State1 : this->States) {
-                vector<vector<string>> temp{{input}, {from,replacement[0],State1}};
-                    cfg.P[{from, stacktop, State1}].push_back(temp);
+    vector<size_t> cut(threads + 1, transitions.size());
+    cut[0] = 0;
+    for (size_t t = 1; t < threads; ++t) {
+        size_t target = offset.back() * t / threads;
+        cut[t] = lower_bound(offset.begin(), offset.end(), target) - offset.begin();
+    }
 
-            }
+    auto build = [&](size_t t) {
+        for (size_t i = cut[t]; i < cut[t + 1]; ++i) {
+            transitionProductions(transitions[i], states, productions.data() + offset[i]);
         }
+    };
+    if (threads == 1) {
+        build(0);
+    } else {
+        vector<thread> workers;
+        for (size_t t = 0; t < threads; ++t) workers.emplace_back(build, t);
+        for (auto &worker : workers) worker.join();
+    }
 
-        else if (replacement.size() == 2) {
-            for (const string& State1 : this->States) {
-                for (const string& State2  : this->States) {
-                    vector<vector<string>> temp{{input}, {from,replacement[0],State2} , {State2,replacement[1],State1}};
-                    cfg.P[{from, stacktop, State1}].push_back(temp);
-                }
-            }
-        }
+    cfg.P.reserve(states.size() + productions.size(), states.size() + 3 * productions.size());
+    uint32_t body[3];
+    for (const Production &production : productions) {
+        body[0] = inputSymbol[production.input < 0 ? Index.Inputs.size() : production.input];
+        for (uint32_t k = 0; k < production.length; ++k) body[k + 1] = cfg.P.triple(production.body[k]);
+        // zonder variabelen is de body zoals vroeger één deel {input}
+        cfg.P.add(cfg.P.triple(production.head), span<const uint32_t>(body, production.length + 1), production.length == 0);
     }
+    cfg.P.compact();
 //-----------------------------------------------------------------------------------------------------------------------------------------------
     //Start variable will always be S this will always be he first variable in V
     cfg.S = cfg.V[0][0];
 
     return cfg;
-}
\ No newline at end of file
+}
+
+void PDA::writeCFG(ostream &out) const {
+    // de codes van transitionProductions zijn 32 bits, net als in toCFG
+    const uint64_t nQ = Index.States.size(), nStack = Index.StackSymbols.size();
+    if (nQ && nStack && (nQ > UINT32_MAX / nQ || nQ * nQ > UINT32_MAX / nStack)) {
+        cerr << "Fout: de PDA heeft te veel variabelen [p,X,q] (|Q|²·|Γ| past niet in 32 bits), geen CFG geschreven." << endl;
+        return;
+    }
+    CFGWriter writer(out);
+
+    writer.variable("S");
+    for (const string& State : this->States) {
+        for (const string& Stacksym : this->StackAlphabet) {
+            for (const string& ReturnState : this->States) {
+                writer.variable(symbolName({State, Stacksym, ReturnState}));
+            }
+        }
+    }
+
+    for (const string &symbol : this->Alphabet) writer.terminal(symbol);
+
+    for (const string& State : this->States) {
+        writer.production("S", {symbolName({this->StartState, this->StartStack, State})});
+    }
+
+    // per transitie de producties maken en meteen wegschrijven, de buffer is hoogstens |Q|² groot
+    vector<uint32_t> states;
+    for (const string& State : this->States) states.push_back(Index.stateId(State));
+    vector<Production> buffer;
+    vector<string> body;
+    for (const CodedTransition &trans : Index.transitions()) {
+        buffer.resize(productionCount(trans));
+        transitionProductions(trans, states, buffer.data());
+        for (const Production &production : buffer) {
+            body.clear();
+            if (production.input >= 0 && !Index.Inputs[production.input].empty()) body.push_back(Index.Inputs[production.input]);
+            for (uint32_t k = 0; k < production.length; ++k) body.push_back(tripleName(production.body[k]));
+            writer.production(tripleName(production.head), body);
+        }
+    }
+
+    writer.start("S");
+}
+
+void PDA::saveCFG(const string &filename) const {
+    ofstream output(filename);
+    if (!output.is_open()) {
+        cerr << "Fout: kon bestand '" << filename << "' niet schrijven." << endl;
+        return;
+    }
+    writeCFG(output);
+}
+
+string PDA::tripleName(uint32_t code) const {
+    const uint32_t nQ = Index.States.size(), nStack = Index.StackSymbols.size();
+    const uint32_t q = code % nQ;
+    code /= nQ;
+    return symbolName({Index.States[code / nStack], Index.StackSymbols[code % nStack], Index.States[q]});
+}
+
+size_t PDA::productionCount(const CodedTransition &trans) const {
+    if (trans.replacementLength == 0) return 1;
+    if (trans.replacementLength == 1) return this->States.size();
+    if (trans.replacementLength == 2) return this->States.size() * this->States.size();
+    return 0;
+}
+
+void PDA::transitionProductions(const CodedTransition &trans, span<const uint32_t> states, Production *out) const {
+    const uint32_t nQ = Index.States.size(), nStack = Index.StackSymbols.size();
+    auto code = [&](uint32_t p, uint32_t X, uint32_t q) { return (p * nStack + X) * nQ + q; };
+    const uint32_t from = trans.from;
+    const uint32_t stacktop = trans.stacktop;
+    span<const int> replacement = Index.replacement(trans);
+
+    if (replacement.size() == 0) {
+        *out = {code(from, stacktop, trans.to), trans.input, {0, 0}, 0};
+    }
+
+    else if (replacement.size() == 1) {
+        const uint32_t push = replacement[0];
+        for (uint32_t State1 : states) {
+            *out++ = {code(from, stacktop, State1), trans.input, {code(from, push, State1), 0}, 1};
+        }
+    }
+
+    else if (replacement.size() == 2) {
+        const uint32_t push0 = replacement[0];
+        const uint32_t push1 = replacement[1];
+        for (uint32_t State1 : states) {
+            for (uint32_t State2 : states) {
+                *out++ = {code(from, stacktop, State1), trans.input, {code(from, push0, State2), code(State2, push1, State1)}, 2};
+            }
+        }
+    }
+}
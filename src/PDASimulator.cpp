@@ -0,0 +1,106 @@
+#include "../include/PDASimulator.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+    uint64_t pack(int a, int b) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+    }
+}
+
+PDASimulator::PDASimulator(const TransitionIndex &index, const EpsilonClosure &closure)
+    : index(index), closure(closure) {
+    for (const CodedTransition &trans : index.transitions()) {
+        longestReplacement = max(longestReplacement, static_cast<size_t>(trans.replacementLength));
+    }
+}
+
+// word met de top vooraan bovenop below zetten, -2 als de stapel te hoog wordt
+int PDASimulator::push(int below, span<const int> word) {
+    int node = below;
+    for (size_t i = word.size(); i-- > 0;) {
+        size_t height = node < 0 ? 1 : nodes[node].height + 1;
+        size_t fixed = (node < 0 ? 0 : nodes[node].fixed) + !closure.erasable(word[i]);
+        if (fixed > remaining) return -2;
+        if (height > heightLimit) {
+            hit = hit || capped;
+            return -2;
+        }
+        auto [it, inserted] = nodeIds.try_emplace(pack(word[i], node), static_cast<int>(nodes.size()));
+        if (inserted) nodes.push_back({word[i], node, height, fixed});
+        node = it->second;
+    }
+    return node;
+}
+
+void PDASimulator::add(int state, int node, bool open) {
+    if (node == -2 || (node >= 0 && nodes[node].fixed > remaining)) return;
+    if (!inNext.insert(pack(state, node)).second) return;
+    next.emplace_back(state, node);
+    if (open) todo.emplace_back(state, node);
+}
+
+// epsilon-afsluiting van next; configuraties uit reach zijn al gesloten, de rest moet nog opengelegd worden
+void PDASimulator::close() {
+    while (!todo.empty()) {
+        auto [state, node] = todo.back();
+        todo.pop_back();
+        if (node < 0) continue;
+
+        int top = nodes[node].symbol;
+        int below = nodes[node].below;
+        for (const auto &entry : closure.reach(state, top)) {
+            add(entry.state, push(below, closure.word(entry)), false);
+        }
+        for (const auto &entry : closure.frontier(state, top)) {
+            add(entry.state, push(below, closure.word(entry)), true);
+        }
+        for (int p : closure.pops(state, top)) {
+            add(p, below, true);
+        }
+    }
+}
+
+bool PDASimulator::accepts(string_view input) {
+    nodes.clear();
+    nodeIds.clear();
+    next.clear();
+    inNext.clear();
+    hit = false;
+    if (index.StartState < 0 || index.StartStack < 0) return false;
+
+    remaining = input.size();
+    // (n+1)·|Q|²·|Γ|·langste vervanging, verzadigd in plaats van over te lopen
+    heightLimit = input.size() + 1;
+    for (size_t factor : {index.States.size(), index.States.size(), index.StackSymbols.size(), longestReplacement}) {
+        heightLimit = factor != 0 && heightLimit > SIZE_MAX / factor ? SIZE_MAX : heightLimit * factor;
+    }
+    capped = MaxHeight != 0 && MaxHeight < heightLimit;
+    if (capped) heightLimit = MaxHeight;
+    int start = index.StartStack;
+    add(index.StartState, push(-1, {&start, 1}), true);
+    close();
+
+    for (char c : input) {
+        int symbol = index.inputOf(static_cast<unsigned char>(c));
+        if (symbol < 0) return false;
+
+        --remaining;
+        current.swap(next);
+        next.clear();
+        inNext.clear();
+        for (auto [state, node] : current) {
+            if (node < 0) continue;
+            for (const CodedTransition &move : index.moves(state, symbol, nodes[node].symbol)) {
+                add(move.to, push(nodes[node].below, index.replacement(move)), true);
+            }
+        }
+        close();
+        if (next.empty()) return false;
+    }
+
+    for (auto [state, node] : next) {
+        if (node < 0) return true;
+    }
+    return false;
+}
@@ -0,0 +1,27 @@
+#include "../include/ParseResult.h"
+
+ParseResult::ParseResult(const CompiledGrammar &grammar, CYKTable table, bool accepted)
+    : accepted(accepted), rules(&grammar), cells(std::move(table)), tableKept(true) {}
+
+void ParseResult::dropTable() {
+    cells = CYKTable();
+    tableKept = false;
+}
+
+bool ParseResult::derives(string_view variable, size_t i, size_t j) const {
+    if (!rules) return false;
+    int A = rules->variableId(variable);
+    return A >= 0 && derives(static_cast<uint32_t>(A), i, j);
+}
+
+vector<string_view> ParseResult::variableNames(size_t i, size_t j) const {
+    vector<string_view> names;
+    forEachVariable(i, j, [&](uint32_t A) { names.push_back(rules->name(A)); });
+    return names;
+}
+
+vector<pair<size_t, size_t>> ParseResult::spans(uint32_t A) const {
+    vector<pair<size_t, size_t>> result;
+    forEachSpan(A, [&](size_t i, size_t j) { result.emplace_back(i, j); });
+    return result;
+}
@@ -0,0 +1,217 @@
+#include "../include/ProductionTable.h"
+#include <algorithm>
+#include <atomic>
+
+namespace {
+    // sleutel voor het opzoeken van een symbool: elk deel gevolgd door een nul
+    string symbolKey(const vector<string> &parts) {
+        string key;
+        for (const auto &part : parts) {
+            key += part;
+            key += '\0';
+        }
+        return key;
+    }
+}
+
+uint64_t ProductionTable::Stamp::next() {
+    static atomic<uint64_t> counter{0};
+    return ++counter;
+}
+
+uint32_t ProductionTable::symbol(const vector<string> &parts) {
+    // een [p,X,q] uit het blok van de triples krijgt dat nummer
+    if (parts.size() == 3 && tripleCount() > 0) {
+        auto p = tripleStateIds.find(parts[0]), X = tripleStackIds.find(parts[1]), q = tripleStateIds.find(parts[2]);
+        if (p != tripleStateIds.end() && X != tripleStackIds.end() && q != tripleStateIds.end()) {
+            return triple(p->second, X->second, q->second);
+        }
+    }
+    auto [it, inserted] = symbolIds.try_emplace(symbolKey(parts), plainId(symbols.size()));
+    if (inserted) symbols.push_back(parts);
+    return it->second;
+}
+
+uint32_t ProductionTable::symbol(const string &name) {
+    string key = name;
+    key += '\0';
+    auto [it, inserted] = symbolIds.try_emplace(std::move(key), plainId(symbols.size()));
+    if (inserted) symbols.push_back({name});
+    return it->second;
+}
+
+bool ProductionTable::addTriples(const vector<string> &states, const vector<string> &stackSymbols) {
+    if (tripleCount() > 0) return false;
+    // symbols + |Q|²·|Γ| moet onder 2^32 blijven; met delingen zodat de vermenigvuldiging zelf niet overloopt
+    const uint64_t nQ = states.size(), nStack = stackSymbols.size();
+    if (symbols.size() >= UINT32_MAX) return false;
+    const uint64_t room = UINT32_MAX - symbols.size();
+    if (nQ && nStack && (nQ > room / nQ || nQ * nQ > room / nStack)) return false;
+    tripleBase = static_cast<uint32_t>(symbols.size());
+    tripleStates = states;
+    tripleStack = stackSymbols;
+    // bij dubbele namen telt de eerste, zoals bij het opzoeken in een map
+    for (uint32_t i = 0; i < states.size(); ++i) tripleStateIds.try_emplace(states[i], i);
+    for (uint32_t i = 0; i < stackSymbols.size(); ++i) tripleStackIds.try_emplace(stackSymbols[i], i);
+    return true;
+}
+
+vector<string> ProductionTable::parts(uint32_t id) const {
+    if (!isTriple(id)) return symbols[plain(id)];
+    vector<string> result;
+    forEachPart(id, [&](const string &part) { result.push_back(part); });
+    return result;
+}
+
+string ProductionTable::name(uint32_t id) const {
+    if (partCount(id) == 1) return symbols[plain(id)][0];
+    string result = "[";
+    bool first = true;
+    forEachPart(id, [&](const string &part) {
+        if (!first) result += ",";
+        result += part;
+        first = false;
+    });
+    return result + "]";
+}
+
+void ProductionTable::add(uint32_t head, span<const uint32_t> body, bool grouped) {
+    rules.push_back({head, static_cast<uint32_t>(bodies.size()), static_cast<uint32_t>(body.size()), grouped});
+    bodies.insert(bodies.end(), body.begin(), body.end());
+    grouping.reset();
+    lazy.grouping.reset();
+}
+
+void ProductionTable::add(const vector<string> &head, const vector<vector<string>> &body) {
+    vector<uint32_t> ids;
+    if (body.size() == 1) {
+        for (const auto &name : body[0]) ids.push_back(symbol(name));
+    } else {
+        for (const auto &part : body) ids.push_back(symbol(part));
+    }
+    add(symbol(head), ids, body.size() == 1);
+}
+
+void ProductionTable::reserve(size_t ruleCount, size_t bodySymbols) {
+    rules.reserve(ruleCount);
+    bodies.reserve(bodySymbols);
+}
+
+void ProductionTable::clear() {
+    *this = ProductionTable();
+}
+
+// heads in de volgorde van de oude map (vector<string> vergelijken), regels stabiel per head.
+// Alles is genummerd over de heads die echt in een regel staan, niet over alle symbolen: het blok
+// triples van toCFG is |Q|²·|Γ| groot, ook voor [p,X,q] die nergens voorkomen.
+shared_ptr<const ProductionTable::Grouping> ProductionTable::group() const {
+    auto result = make_shared<Grouping>();
+    vector<uint32_t> ids;
+    ids.reserve(rules.size());
+    for (const Rule &rule : rules) ids.push_back(rule.head);
+    sort(ids.begin(), ids.end());
+    ids.erase(unique(ids.begin(), ids.end()), ids.end());
+    auto position = [&](uint32_t head) { return lower_bound(ids.begin(), ids.end(), head) - ids.begin(); };
+
+    vector<vector<string>> names(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i) names[i] = parts(ids[i]);
+    vector<uint32_t> byName(ids.size());
+    for (uint32_t i = 0; i < byName.size(); ++i) byName[i] = i;
+    sort(byName.begin(), byName.end(), [&](uint32_t a, uint32_t b) { return names[a] < names[b]; });
+
+    vector<uint32_t> slot(ids.size(), 0);
+    result->heads.resize(ids.size());
+    for (uint32_t h = 0; h < byName.size(); ++h) {
+        slot[byName[h]] = h;
+        result->heads[h] = ids[byName[h]];
+    }
+
+    vector<uint32_t> ruleSlot(rules.size());
+    result->headStart.assign(result->heads.size() + 1, 0);
+    for (uint32_t r = 0; r < rules.size(); ++r) {
+        ruleSlot[r] = slot[position(rules[r].head)];
+        ++result->headStart[ruleSlot[r] + 1];
+    }
+    for (size_t h = 0; h < result->heads.size(); ++h) result->headStart[h + 1] += result->headStart[h];
+
+    result->order.resize(rules.size());
+    vector<uint32_t> next(result->headStart.begin(), result->headStart.end() - 1);
+    for (uint32_t r = 0; r < rules.size(); ++r) result->order[next[ruleSlot[r]]++] = r;
+    return result;
+}
+
+shared_ptr<const ProductionTable::Grouping> ProductionTable::grouped() const {
+    if (grouping) return grouping;
+    lock_guard<mutex> guard(lazy.lock);
+    if (!lazy.grouping) lazy.grouping = group();
+    return lazy.grouping;
+}
+
+void ProductionTable::compact() {
+    if (grouping) return;
+    shared_ptr<const Grouping> current = group();
+    lazy.grouping.reset();
+
+    // regels en bodies in de gegroepeerde volgorde herschrijven, daarna is order de identiteit
+    vector<Rule> sortedRules;
+    vector<uint32_t> sortedBodies;
+    sortedRules.reserve(rules.size());
+    sortedBodies.reserve(bodies.size());
+    for (uint32_t r : current->order) {
+        Rule rule = rules[r];
+        auto rhs = body(rule);
+        rule.bodyStart = static_cast<uint32_t>(sortedBodies.size());
+        sortedBodies.insert(sortedBodies.end(), rhs.begin(), rhs.end());
+        sortedRules.push_back(rule);
+    }
+    rules = std::move(sortedRules);
+    bodies = std::move(sortedBodies);
+
+    auto identity = make_shared<Grouping>(*current);
+    for (uint32_t r = 0; r < identity->order.size(); ++r) identity->order[r] = r;
+    grouping = std::move(identity);
+}
+
+vector<vector<string>> ProductionTable::legacyBody(const Rule &rule) const {
+    vector<vector<string>> result;
+    if (rule.grouped) {
+        result.emplace_back();
+        for (uint32_t sym : body(rule)) forEachPart(sym, [&](const string &part) { result[0].push_back(part); });
+    } else {
+        for (uint32_t sym : body(rule)) result.push_back(parts(sym));
+    }
+    return result;
+}
+
+size_t ProductionTable::size() const {
+    return grouped()->heads.size();
+}
+
+ProductionTable::const_iterator ProductionTable::begin() const {
+    const_iterator it;
+    it.table = this;
+    it.grouping = grouped();
+    return it;
+}
+
+ProductionTable::const_iterator ProductionTable::end() const {
+    const_iterator it;
+    it.table = this;
+    it.index = size();
+    return it;
+}
+
+ProductionTable::Legacy::value_type ProductionTable::const_iterator::operator*() const {
+    uint32_t head = grouping->heads[index];
+    vector<vector<vector<string>>> result;
+    for (uint32_t i = grouping->headStart[index]; i < grouping->headStart[index + 1]; ++i) {
+        result.push_back(table->legacyBody(table->rule(grouping->order[i])));
+    }
+    return {table->parts(head), std::move(result)};
+}
+
+ProductionTable::Legacy ProductionTable::legacy() const {
+    Legacy result;
+    for (const auto &[head, bodyList] : *this) result.emplace(head, bodyList);
+    return result;
+}
@@ -0,0 +1,128 @@
+#include "../include/ResultCache.h"
+#include "../include/CYKParser.h"
+#include <algorithm>
+#include <functional>
+
+ResultCache::ResultCache(size_t capacity, size_t shardCount) {
+    if (capacity == 0) return;
+    shardCount = max<size_t>(1, min(shardCount, capacity));
+    for (size_t s = 0; s < shardCount; ++s) {
+        auto shard = make_unique<Shard>();
+        // de capaciteit zo eerlijk mogelijk over de shards verdelen
+        shard->slots.resize(capacity / shardCount + (s < capacity % shardCount ? 1 : 0));
+        shard->index.reserve(shard->slots.size());
+        shards.push_back(std::move(shard));
+    }
+}
+
+uint64_t ResultCache::key(uint64_t grammar, string_view input) {
+    uint64_t h = hash<string_view>()(input) ^ (grammar * 0x9E3779B97F4A7C15ull);
+    // bits mengen (splitmix64), zodat de bovenste bits ook goed verdeeld zijn voor de keuze van de shard
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    return h ^ (h >> 31);
+}
+
+optional<bool> ResultCache::find(const CompiledGrammar &grammar, string_view input) {
+    if (shards.empty()) {
+        misses.fetch_add(1, memory_order_relaxed);
+        return nullopt;
+    }
+    const uint64_t serial = grammar.serial();
+    const uint64_t hash = key(serial, input);
+    Shard &shard = shardOf(hash);
+    lock_guard<mutex> guard(shard.lock);
+
+    auto it = shard.index.find(hash);
+    if (it != shard.index.end()) {
+        Entry &entry = shard.slots[it->second];
+        if (entry.grammar == serial && entry.input == input) {
+            entry.referenced = true;
+            hits.fetch_add(1, memory_order_relaxed);
+            return entry.accepted;
+        }
+    }
+    misses.fetch_add(1, memory_order_relaxed);
+    return nullopt;
+}
+
+void ResultCache::insert(const CompiledGrammar &grammar, string_view input, bool accepted) {
+    if (shards.empty()) return;
+    const uint64_t serial = grammar.serial();
+    const uint64_t hash = key(serial, input);
+    Shard &shard = shardOf(hash);
+    lock_guard<mutex> guard(shard.lock);
+
+    auto it = shard.index.find(hash);
+    if (it != shard.index.end()) {
+        Entry &entry = shard.slots[it->second];
+        if (entry.grammar == serial && entry.input == input) {
+            entry.accepted = accepted;
+            return;
+        }
+    }
+
+    // CLOCK: items die gebruikt zijn krijgen nog een ronde, het eerste zonder referentie gaat eruit
+    while (shard.slots[shard.hand].used && shard.slots[shard.hand].referenced) {
+        shard.slots[shard.hand].referenced = false;
+        shard.hand = (shard.hand + 1) % shard.slots.size();
+    }
+    const uint32_t slot = static_cast<uint32_t>(shard.hand);
+    shard.hand = (shard.hand + 1) % shard.slots.size();
+
+    Entry &victim = shard.slots[slot];
+    if (victim.used) {
+        auto old = shard.index.find(victim.hash);
+        if (old != shard.index.end() && old->second == slot) shard.index.erase(old);
+        evictions.fetch_add(1, memory_order_relaxed);
+    }
+    victim.hash = hash;
+    victim.grammar = serial;
+    victim.input.assign(input);
+    victim.accepted = accepted;
+    victim.referenced = false;
+    victim.used = true;
+    // bij een botsing met een andere invoer wint de nieuwste
+    shard.index[hash] = slot;
+}
+
+bool ResultCache::accepts(const CompiledGrammar &grammar, string_view input) {
+    if (optional<bool> cached = find(grammar, input)) return *cached;
+
+    // één parser per thread, zoals de runner in PDA::accepts; het serienummer vangt een nieuwe
+    // grammatica op hetzelfde adres op
+    thread_local uint64_t serial = 0;
+    thread_local unique_ptr<CYKParser> parser;
+    if (!parser || serial != grammar.serial()) {
+        parser = make_unique<CYKParser>(grammar);
+        serial = grammar.serial();
+    }
+    bool accepted = parser->accepts(input);
+    insert(grammar, input, accepted);
+    return accepted;
+}
+
+ResultCache::Stats ResultCache::stats() const {
+    Stats result;
+    result.hits = hits.load(memory_order_relaxed);
+    result.misses = misses.load(memory_order_relaxed);
+    result.evictions = evictions.load(memory_order_relaxed);
+    return result;
+}
+
+size_t ResultCache::capacity() const {
+    size_t total = 0;
+    for (const auto &shard : shards) total += shard->slots.size();
+    return total;
+}
+
+void ResultCache::clear() {
+    for (auto &shard : shards) {
+        lock_guard<mutex> guard(shard->lock);
+        for (Entry &entry : shard->slots) entry = Entry();
+        shard->index.clear();
+        shard->hand = 0;
+    }
+}
@@ -0,0 +1,115 @@
+#include "../include/TableRenderer.h"
+#include "../include/CFGWriter.h"
+
+TableRenderer::TableRenderer(ostream &out, Format format) : out(out), format(format) {}
+
+void TableRenderer::flushIfFull() {
+    if (buffer.size() >= FlushSize) flush();
+}
+
+void TableRenderer::flush() {
+    out.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+    buffer.clear();
+}
+
+void TableRenderer::render(const ParseResult &result) {
+    switch (format) {
+        case Text: renderText(result); break;
+        case JSON: renderJSON(result); break;
+        case HTML: renderHTML(result); break;
+    }
+    flush();
+    out.flush();
+}
+
+void TableRenderer::renderText(const ParseResult &result) {
+    if (result.hasTable()) {
+        // de variabelen van een cel staan al alfabetisch en zonder duplicaten in de bitset
+        const size_t n = result.length();
+        for (size_t length = n; length >= 1; --length) {
+            for (size_t start = 0; start + length <= n; ++start) {
+                buffer += "| {";
+                bool first = true;
+                result.forEachVariable(start, start + length, [&](uint32_t var) {
+                    if (!first) buffer += ", ";
+                    buffer += result.grammar().name(var);
+                    first = false;
+                });
+                buffer += "}  ";
+            }
+            buffer += "|\n";
+            flushIfFull();
+        }
+    }
+
+    buffer += result.accepted ? "true\n" : "false\n";
+}
+
+void TableRenderer::renderJSON(const ParseResult &result) {
+    buffer += "{\"accepted\": ";
+    buffer += result.accepted ? "true" : "false";
+    if (result.hasTable()) {
+        const size_t n = result.length();
+        buffer += ", \"length\": " + to_string(n) + ", \"rows\": [";
+        for (size_t length = n; length >= 1; --length) {
+            buffer += length == n ? "[" : ", [";
+            for (size_t start = 0; start + length <= n; ++start) {
+                buffer += start == 0 ? "[" : ", [";
+                bool first = true;
+                result.forEachVariable(start, start + length, [&](uint32_t var) {
+                    if (!first) buffer += ", ";
+                    appendJSONString(buffer, result.grammar().name(var));
+                    first = false;
+                });
+                buffer += "]";
+            }
+            buffer += "]";
+            flushIfFull();
+        }
+        buffer += "]";
+    }
+    buffer += "}\n";
+}
+
+void TableRenderer::renderHTML(const ParseResult &result) {
+    buffer += "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n<title>CYK</title>\n<style>\n"
+              "table { border-collapse: collapse; font-family: monospace; }\n"
+              "td { border: 1px solid #999; padding: 2px 6px; }\n"
+              "td.empty { color: #bbb; }\n"
+              "</style>\n</head>\n<body>\n";
+    if (result.hasTable()) {
+        const size_t n = result.length();
+        buffer += "<table>\n";
+        for (size_t length = n; length >= 1; --length) {
+            buffer += "<tr>";
+            for (size_t start = 0; start + length <= n; ++start) {
+                const bool empty = !anyBit(result.variables(start, start + length), result.table().words);
+                buffer += empty ? "<td class=\"empty\">&empty;" : "<td>";
+                bool first = true;
+                result.forEachVariable(start, start + length, [&](uint32_t var) {
+                    if (!first) buffer += ", ";
+                    escapeHTML(result.grammar().name(var));
+                    first = false;
+                });
+                buffer += "</td>";
+            }
+            buffer += "</tr>\n";
+            flushIfFull();
+        }
+        buffer += "</table>\n";
+    }
+    buffer += result.accepted ? "<p>true</p>\n" : "<p>false</p>\n";
+    buffer += "</body>\n</html>\n";
+}
+
+void TableRenderer::escapeHTML(string_view text) {
+    for (char c : text) {
+        switch (c) {
+            case '&': buffer += "&amp;"; break;
+            case '<': buffer += "&lt;"; break;
+            case '>': buffer += "&gt;"; break;
+            case '"': buffer += "&quot;"; break;
+            default: buffer += c;
+        }
+    }
+}
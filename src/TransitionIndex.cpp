@@ -0,0 +1,106 @@
+#include "../include/TransitionIndex.h"
+#include "../include/PDA.h"
+#include <atomic>
+
+namespace {
+    int intern(const string &name, vector<string> &names, map<string, int> &ids) {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        int id = static_cast<int>(names.size());
+        names.push_back(name);
+        ids.emplace(name, id);
+        return id;
+    }
+
+    int lookup(const string &name, const map<string, int> &ids) {
+        auto it = ids.find(name);
+        return it == ids.end() ? -1 : it->second;
+    }
+
+    // stabiele counting sort van de transities op hun sleutel, met CSR-offsets erbij
+    void group(const vector<CodedTransition> &in, size_t keys, auto key,
+               vector<CodedTransition> &out, vector<int> &start) {
+        start.assign(keys + 1, 0);
+        for (const auto &t : in) ++start[key(t) + 1];
+        for (size_t k = 0; k < keys; ++k) start[k + 1] += start[k];
+
+        out.resize(in.size());
+        vector<int> fill(start.begin(), start.end() - 1);
+        for (const auto &t : in) out[fill[key(t)]++] = t;
+    }
+}
+
+TransitionIndex::TransitionIndex(const PDA &pda) {
+    for (const string &state : pda.States) intern(state, States, stateIds);
+    for (const string &symbol : pda.Alphabet) intern(symbol, Inputs, inputIds);
+    for (const string &symbol : pda.StackAlphabet) intern(symbol, StackSymbols, stackIds);
+
+    // transities coderen; namen die niet gedeclareerd zijn krijgen er gewoon een nummer bij
+    vector<CodedTransition> inputMoves, epsilonMoves;
+    for (size_t i = 0; i < pda.Transitions.size(); ++i) {
+        const Transition &trans = pda.Transitions[i];
+        CodedTransition coded{};
+        coded.from = intern(trans.from, States, stateIds);
+        coded.input = trans.input.empty() ? -1 : intern(trans.input, Inputs, inputIds);
+        coded.stacktop = intern(trans.stacktop, StackSymbols, stackIds);
+        coded.to = intern(trans.to, States, stateIds);
+        coded.replacementStart = static_cast<int>(replacements.size());
+        coded.replacementLength = static_cast<int>(trans.replacement.size());
+        coded.source = static_cast<int>(i);
+        for (const string &symbol : trans.replacement) {
+            replacements.push_back(intern(symbol, StackSymbols, stackIds));
+        }
+        ordered.push_back(coded);
+    }
+    StartState = intern(pda.StartState, States, stateIds);
+    StartStack = intern(pda.StartStack, StackSymbols, stackIds);
+
+    const size_t nInputs = Inputs.size();
+    const size_t nStack = StackSymbols.size();
+
+    for (const auto &t : ordered) (t.input < 0 ? epsilonMoves : inputMoves).push_back(t);
+    group(inputMoves, States.size() * nInputs * nStack, [&](const CodedTransition &t) {
+        return (static_cast<size_t>(t.from) * nInputs + t.input) * nStack + t.stacktop;
+    }, grouped, moveStart);
+    group(epsilonMoves, States.size() * nStack, [&](const CodedTransition &t) {
+        return static_cast<size_t>(t.from) * nStack + t.stacktop;
+    }, epsilon, epsilonStart);
+
+    byteInput.fill(-1);
+    for (size_t i = 0; i < nInputs; ++i) {
+        if (Inputs[i].size() == 1) byteInput[static_cast<unsigned char>(Inputs[i][0])] = static_cast<int>(i);
+    }
+
+    deterministic = checkDeterministic();
+    static atomic<uint64_t> built{0};
+    id = ++built;
+}
+
+int TransitionIndex::stateId(const string &name) const {
+    return lookup(name, stateIds);
+}
+
+int TransitionIndex::inputId(const string &name) const {
+    return lookup(name, inputIds);
+}
+
+int TransitionIndex::stackId(const string &name) const {
+    return lookup(name, stackIds);
+}
+
+bool TransitionIndex::checkDeterministic() const {
+    const int nStates = static_cast<int>(States.size());
+    const int nStack = static_cast<int>(StackSymbols.size());
+    const int nInputs = static_cast<int>(Inputs.size());
+    for (int state = 0; state < nStates; ++state) {
+        for (int top = 0; top < nStack; ++top) {
+            size_t eps = epsilonMoves(state, top).size();
+            if (eps > 1) return false;
+            for (int input = 0; input < nInputs; ++input) {
+                size_t count = moves(state, input, top).size();
+                if (count > 1 || (count == 1 && eps == 1)) return false;
+            }
+        }
+    }
+    return true;
+}
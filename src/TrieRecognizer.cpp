@@ -0,0 +1,96 @@
+#include "../include/TrieRecognizer.h"
+#include "../include/Bits.h"
+#include <algorithm>
+
+TrieRecognizer::TrieRecognizer(const CompiledGrammar &grammar) : grammar(grammar) {}
+
+// knoop 0 is de wortel; kinderen staan in een gelinkte lijst, het alfabet is meestal klein
+void TrieRecognizer::build(const vector<string> &inputs) {
+    nodes.assign(1, Node());
+    nextInput.assign(inputs.size(), -1);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        uint32_t node = 0;
+        for (char ch : inputs[i]) {
+            const unsigned char c = static_cast<unsigned char>(ch);
+            uint32_t child = nodes[node].firstChild;
+            while (child && nodes[child].byte != c) child = nodes[child].nextSibling;
+            if (!child) {
+                child = static_cast<uint32_t>(nodes.size());
+                Node added;
+                added.byte = c;
+                added.nextSibling = nodes[node].firstChild;
+                nodes.push_back(added);
+                nodes[node].firstChild = child;
+            }
+            node = child;
+        }
+        nextInput[i] = nodes[node].firstInput;
+        nodes[node].firstInput = static_cast<int64_t>(i);
+    }
+}
+
+vector<bool> TrieRecognizer::accepts(const vector<string> &inputs) {
+    vector<bool> result(inputs.size(), false);
+    if (grammar.start() < 0) return result;
+    build(inputs);
+
+    size_t longest = 0;
+    for (const string &input : inputs) longest = max(longest, input.size());
+    columns.assign(longest * (longest + 1) / 2 * grammar.words(), 0);
+
+    const uint32_t start = static_cast<uint32_t>(grammar.start());
+    auto finish = [&](uint32_t node, size_t depth) {
+        for (int64_t i = nodes[node].firstInput; i >= 0; i = nextInput[i]) {
+            if (!grammar.mayAccept(inputs[i])) continue;
+            result[i] = depth == 0 ? grammar.derivesEmpty() : testBit(cell(depth, depth), start);
+        }
+    };
+    finish(0, 0);
+
+    // diepte eerst zonder recursie: path[d] is de knoop op diepte d, next[d] het volgende kind om te bezoeken
+    vector<uint32_t> path{0};
+    vector<uint32_t> next{nodes[0].firstChild};
+    while (!path.empty()) {
+        const size_t depth = path.size() - 1;
+        const uint32_t child = next[depth];
+        if (!child) {
+            path.pop_back();
+            next.pop_back();
+            continue;
+        }
+        next[depth] = nodes[child].nextSibling;
+
+        column(depth + 1, nodes[child].byte);
+        finish(child, depth + 1);
+        path.push_back(child);
+        next.push_back(nodes[child].firstChild);
+    }
+    return result;
+}
+
+// kolom na depth tekens, c is het laatste; de linkerdelen zitten in de kolommen van de voorouders
+void TrieRecognizer::column(size_t depth, unsigned char c) {
+    const size_t words = grammar.words();
+
+    uint64_t *base = cell(depth, 1);
+    const uint64_t *vars = grammar.byteVariables(c);
+    copy(vars, vars + words, base);
+    for (size_t length = 2; length <= depth; ++length) fill(cell(depth, length), cell(depth, length) + words, 0);
+
+    for (size_t length = 2; length <= depth; ++length) {
+        if (!grammar.lengthPossible(length)) continue;
+        uint64_t *into = cell(depth, length);
+        for (size_t split = 1; split < length; ++split) {
+            const uint64_t *left = cell(depth - (length - split), split);
+            const uint64_t *right = cell(depth, length - split);
+            if (!anyBit(left, words) || !anyBit(right, words)) continue;
+
+            forEachBit(left, words, [&](uint32_t B) {
+                auto rules = grammar.binaryRules(B, length);
+                for (size_t r = 0; r < rules.size(); r += 2) {
+                    if (testBit(right, rules[r])) setBit(into, rules[r + 1]);
+                }
+            });
+        }
+    }
+}